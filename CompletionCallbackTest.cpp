@@ -0,0 +1,65 @@
+//
+//  CompletionCallbackTest.cpp
+//  CloudSim
+//
+//  Stands in for the scheduler to check what the simulator allows inside a
+//  completion callback, run with make test. Machine 0 time-slices two tasks
+//  per core, and a queued task is added whenever one completes: from inside
+//  the completion callback when COMPLETION_TEST_IN_CALLBACK is set, otherwise
+//  from the next arrival or periodic check, as Scheduler.cpp does.
+//
+
+#include <cstdlib>
+#include <deque>
+
+#include "Interfaces.h"
+
+static const unsigned TASKS_PER_CORE = 2;
+
+static bool in_callback = getenv("COMPLETION_TEST_IN_CALLBACK") != nullptr;
+static VMId_t vm_id;
+static unsigned capacity = 0;
+static unsigned running = 0;
+static uint64_t completed = 0;
+static deque<TaskId_t> queued;
+
+static void Fill() {
+    while(running < capacity && !queued.empty()) {
+        VM_AddTask(vm_id, queued.front(), MID_PRIORITY);
+        queued.pop_front();
+        running++;
+    }
+}
+
+void InitScheduler() {
+    vm_id = VM_Create(LINUX, X86);
+    VM_Attach(vm_id, 0);
+    capacity = Machine_GetInfo(0).num_cpus * TASKS_PER_CORE;
+}
+
+void HandleNewTask(Time_t time, TaskId_t task_id) {
+    queued.push_back(task_id);
+    Fill();
+}
+
+void HandleTaskCompletion(Time_t time, TaskId_t task_id) {
+    running--;
+    completed++;
+    if(in_callback)
+        Fill();
+}
+
+void MemoryWarning(Time_t time, MachineId_t machine_id) {}
+void MigrationDone(Time_t time, VMId_t vm_id) {}
+
+void SchedulerCheck(Time_t time) {
+    Fill();
+}
+
+void SimulationComplete(Time_t time) {
+    cout << "CompletionCallbackTest: " << completed << " of " << GetNumTasks() << " tasks completed, added "
+         << (in_callback ? "inside" : "after") << " the completion callback" << endl;
+}
+
+void SLAWarning(Time_t time, TaskId_t task_id) {}
+void StateChangeComplete(Time_t time, MachineId_t machine_id) {}
@@ -0,0 +1,89 @@
+//
+//  DecisionLog.cpp
+//  CloudSim
+//
+
+#include <cstdio>
+#include <sstream>
+
+#include "DecisionLog.hpp"
+
+static Time_t RecordTime(const string & record) {
+    istringstream fields(record);
+    char type;
+    Time_t time = 0;
+    fields >> type >> time;
+    return time;
+}
+
+void DecisionLog::Init(string path, unsigned checkpoint_interval) {
+    enabled = true;
+    this->path = path;
+    this->checkpoint_interval = checkpoint_interval;
+    previous.open(path);
+    current.open(path + ".new");
+}
+
+void DecisionLog::Record(RecordType_t type, Time_t now, uint64_t id) {
+    if(!enabled)
+        return;
+    string record = string(1, char(type)) + " " + to_string(now) + " " + to_string(id);
+    current << record << '\n';
+    records++;
+    if(diverged || !previous.is_open())
+        return;
+    string recorded;
+    if(!getline(previous, recorded))
+        recorded = "end of the previous run";
+    else if(recorded == record)
+        return;
+    diverged = true;
+    divergence_record = records;
+    divergence_time = now;
+    expected = recorded;
+    actual = record;
+}
+
+void DecisionLog::Checkpoint(Time_t now) {
+    if(!enabled || ++checks % checkpoint_interval != 0)
+        return;
+    Record(CHECKPOINT_RECORD, now, checks);
+    if(!diverged)
+        last_checkpoint = now;
+}
+
+void DecisionLog::Report() {
+    if(!enabled)
+        return;
+    if(previous.is_open()) {
+        // Whatever the previous run recorded past this point gives its length
+        string recorded;
+        Time_t recorded_end = divergence_time;
+        while(getline(previous, recorded)) {
+            recorded_end = RecordTime(recorded);
+            if(diverged)
+                continue;
+            // The previous run went on, its first record past the end of this run is the divergence
+            diverged = true;
+            divergence_record = records + 1;
+            divergence_time = recorded_end;
+            expected = recorded;
+            actual = "end of this run";
+        }
+        if(!diverged) {
+            cout << "Decision log: identical to the previous run (" << records << " records)" << endl;
+        }
+        else {
+            cout << "Decision log: first divergence at time " << divergence_time << " (record " << divergence_record << "), expected '"
+                 << expected << "' got '" << actual << "'" << endl;
+            cout << "Decision log: last matching checkpoint at time " << last_checkpoint << ", the divergence lies "
+                 << (recorded_end ? 100.0 * divergence_time / recorded_end : 0) << "% into the previous run" << endl;
+        }
+        previous.close();
+    }
+    else {
+        cout << "Decision log: recorded " << records << " records to " << path << endl;
+    }
+    current.close();
+    rename((path + ".new").c_str(), path.c_str());
+}
@@ -0,0 +1,56 @@
+//
+//  DecisionLog.hpp
+//  CloudSim
+//
+//  Records the stream of scheduler callbacks of a run and compares it with
+//  the stream recorded by the previous run, to find the first point where
+//  the two runs diverge. Placement, migration and power decisions change
+//  the completion, migration and state change callbacks that follow them,
+//  so the first differing record bounds the first differing decision.
+//  A checkpoint mark is written every few periodic checks, and the report
+//  names the last mark before the divergence and how far into the previous
+//  run the divergence lies.
+//
+
+#ifndef DecisionLog_hpp
+#define DecisionLog_hpp
+
+#include <fstream>
+#include <string>
+
+#include "SimTypes.h"
+
+typedef enum {
+    ARRIVAL_RECORD = 'A',
+    COMPLETION_RECORD = 'C',
+    CHECKPOINT_RECORD = 'K',
+    MEMORY_RECORD = 'M',
+    MIGRATION_RECORD = 'V',
+    SLA_RECORD = 'L',
+    STATE_RECORD = 'S'
+} RecordType_t;
+
+class DecisionLog {
+public:
+    DecisionLog()               {}
+    void Checkpoint(Time_t now);
+    void Init(string path, unsigned checkpoint_interval);
+    void Record(RecordType_t type, Time_t now, uint64_t id);
+    void Report();
+private:
+    bool enabled = false;
+    string path;
+    ifstream previous;                      // Log of the previous run, empty on the first run
+    ofstream current;
+    uint64_t records = 0;
+    unsigned checks = 0;
+    unsigned checkpoint_interval;
+    Time_t last_checkpoint = 0;             // Last checkpoint mark that matched the previous run
+    bool diverged = false;
+    uint64_t divergence_record = 0;
+    Time_t divergence_time = 0;
+    string expected;                        // Record of the previous run at the divergence
+    string actual;
+};
+
+#endif /* DecisionLog_hpp */
@@ -0,0 +1,147 @@
+//
+//  Efficiency.cpp
+//  CloudSim
+//
+
+#include "Efficiency.hpp"
+#include "Internal_Interfaces.h"
+
+void Efficiency::Init(string path, Slowdown * slowdown) {
+    this->slowdown = slowdown;
+    for(unsigned task_class = 0; task_class < TASK_CLASSES; task_class++)
+        sensitivity[task_class] = {1};
+    for(unsigned cpu = 0; cpu < CPU_TYPES; cpu++) {
+        energy_per_instruction[cpu] = 0;
+        for(unsigned task_class = 0; task_class < TASK_CLASSES; task_class++)
+            matrix[cpu][task_class] = Efficiency_t{1, 1};
+    }
+    for(unsigned i = Machine_GetTotal(); i > 0; i--) {
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i - 1));
+        energy_per_instruction[info.cpu] = double(info.p_states[P0]) / info.performance[P0];
+    }
+
+    vector<InputBlock_t> blocks = ReadInputBlocks(path);
+    classes = ReadTaskClasses(blocks);
+    for(auto & block: blocks) {
+        auto fields = block.fields;
+        if(block.type == "efficiency") {
+            unsigned cpu = ParseName(cpu_type_names, CPU_TYPES, fields["CPU type"], "CPU type");
+            unsigned task_class = ParseName(task_type_names, TASK_CLASSES, fields["Task type"], "task type");
+            matrix[cpu][task_class] = Efficiency_t{stod(fields["Throughput"]), stod(fields["Power"])};
+            if(matrix[cpu][task_class].throughput <= 0)
+                ThrowException("Efficiency::Init(): Throughput must be positive for " + string(cpu_type_names[cpu]) + " ", task_type_names[task_class]);
+        }
+        else if(block.type == "frequency sensitivity") {
+            unsigned task_class = ParseName(task_type_names, TASK_CLASSES, fields["Task type"], "task type");
+            sensitivity[task_class] = ParseBracketedValues(fields["Sensitivity"]);
+            if(sensitivity[task_class].empty())
+                ThrowException("Efficiency::Init(): No sensitivity given for task type ", task_type_names[task_class]);
+        }
+    }
+}
+
+void Efficiency::TaskArrived(Time_t now, TaskId_t task_id) {
+    int spec = MatchTaskClass(classes, now, task_id);
+    if(spec < 0) {
+        unclassified++;
+        return;
+    }
+    TaskClass_t task_class = classes[spec].task_class;
+    // A task only runs on its required CPU type, so its throughput is known before placement
+    CPUType_t cpu = RequiredCPUType(task_id);
+    uint64_t instructions = uint64_t(double(GetTaskInfo(task_id).total_instructions) / matrix[cpu][task_class].throughput);
+    if(instructions == 0)
+        instructions = 1;
+    // The task runs as at P0 until its machine is known
+    slowdown->Set(task_id, EFFICIENCY_SLOWDOWN, 1 / matrix[cpu][task_class].throughput);
+    slowdown->Apply(task_id, 0, false);
+    tasks[task_id] = EfficiencyTask_t{cpu, task_class, instructions, 0, 1};
+}
+
+double Efficiency::Remaining(TaskId_t task_id, const EfficiencyTask_t & task) {
+    // Instructions left after the throughput multiplier, without the factor of any P-state
+    return slowdown->Unscaled(task_id) / matrix[task.cpu][task.task_class].throughput;
+}
+
+double Efficiency::Sensitivity(TaskId_t task_id, const EfficiencyTask_t & task) {
+    // The phases split the instructions of the task evenly
+    const vector<double> & phases = sensitivity[task.task_class];
+    double remaining = Remaining(task_id, task);
+    double progress = 1 - min(remaining / double(task.instructions), 1.0);
+    return phases[min(unsigned(progress * phases.size()), unsigned(phases.size() - 1))];
+}
+
+double Efficiency::PredictedSlowdown(TaskId_t task_id, MachineId_t machine_id, CPUPerformance_t p_state) {
+    // Run time at p_state against P0: the sensitive share slows with the MIPS ratio, the rest does not
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    double ratio = double(info.performance[p_state]) / info.performance[P0];
+    auto it = tasks.find(task_id);
+    double share = it == tasks.end() ? 1 : Sensitivity(task_id, it->second);
+    return share / ratio + 1 - share;
+}
+
+void Efficiency::Rescale(TaskId_t task_id, EfficiencyTask_t & task) {
+    MachineInfo_t info = Machine_GetInfo(task.machine_id);
+    double ratio = double(info.performance[info.p_state]) / info.performance[P0];
+    double share = Sensitivity(task_id, task);
+    double factor = share + (1 - share) * ratio;
+    if(factor == task.factor)
+        return;
+    slowdown->Set(task_id, EFFICIENCY_SLOWDOWN, factor / matrix[task.cpu][task.task_class].throughput);
+    task.factor = factor;
+    rescales++;
+}
+
+void Efficiency::Placed(TaskId_t task_id, MachineId_t machine_id) {
+    auto it = tasks.find(task_id);
+    if(it == tasks.end())
+        return;
+    // Called before the task is added, the scheduler applies the ledger once every model placed it
+    it->second.machine_id = machine_id;
+    placed.insert(task_id);
+    Rescale(task_id, it->second);
+}
+
+void Efficiency::PeriodicCheck(Time_t now) {
+    // P-state changes and phase changes are picked up here, so the instructions lag them by at most one check
+    // A lowering the ledger held back at an earlier check is applied as far as it can go now
+    for(auto task_id: placed) {
+        if(IsTaskCompleted(task_id))
+            continue;
+        EfficiencyTask_t & task = tasks[task_id];
+        Rescale(task_id, task);
+        slowdown->Apply(task_id, task.machine_id, true);
+    }
+}
+
+void Efficiency::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids)
+        placed.erase(task_id);
+}
+
+void Efficiency::Report() {
+    // Active core energy of the instructions executed so far, charged by the simulator at the P-state table
+    uint64_t counts[CPU_TYPES][TASK_CLASSES] = {};
+    double adjustments[CPU_TYPES][TASK_CLASSES] = {};
+    double adjustment = 0;
+    for(auto & [task_id, task]: tasks) {
+        uint64_t remaining = min(uint64_t(Remaining(task_id, task)), task.instructions);
+        double active = double(task.instructions - remaining) * energy_per_instruction[task.cpu];
+        double extra = active * (matrix[task.cpu][task.task_class].power - 1);
+        counts[task.cpu][task.task_class]++;
+        adjustments[task.cpu][task.task_class] += extra;
+        adjustment += extra;
+    }
+    for(unsigned cpu = 0; cpu < CPU_TYPES; cpu++) {
+        for(unsigned task_class = 0; task_class < TASK_CLASSES; task_class++) {
+            if(!counts[cpu][task_class])
+                continue;
+            cout << "Efficiency: " << cpu_type_names[cpu] << " " << task_type_names[task_class] << " " << counts[cpu][task_class] << " tasks, throughput "
+                 << matrix[cpu][task_class].throughput << ", power " << matrix[cpu][task_class].power << ", active energy adjustment "
+                 << adjustments[cpu][task_class] / 3600000000000.0 << "KW-Hour" << endl;
+        }
+    }
+    cout << "Efficiency: " << unclassified << " tasks matched no task class, cluster energy with the power multipliers "
+         << Machine_GetClusterEnergy() + adjustment / 3600000000000.0 << "KW-Hour" << endl;
+    cout << "Efficiency: " << rescales << " frequency sensitivity rescales" << endl;
+}
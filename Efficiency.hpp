@@ -0,0 +1,76 @@
+//
+//  Efficiency.hpp
+//  CloudSim
+//
+//  Per CPU type and task class efficiency. The MIPS table of a machine
+//  converts instructions to time the same way for every workload, so the
+//  input can give an "efficiency:" block per CPU type and task type with a
+//  throughput and a power multiplier. The simulator does not expose the
+//  class of a task, so every arrival is matched against the task classes
+//  of the same input. The throughput multiplier is applied by scaling the
+//  instructions of the task when it arrives, which every projection that
+//  reads the remaining instructions then sees. The power multiplier is
+//  applied to the active core energy of those instructions in a ledger.
+//  A "frequency sensitivity:" block gives the share of a task class that
+//  slows down with the clock, optionally as a list of phases over its
+//  instructions. The simulator slows every instruction by the MIPS ratio
+//  of the P-state, so a placed task is given fewer instructions at lower
+//  P-states in the proportion its memory bound share would not have slowed.
+//  Both multipliers go into the slowdown ledger as one factor, which
+//  rescales the instructions both ways at every periodic check.
+//
+
+#ifndef Efficiency_hpp
+#define Efficiency_hpp
+
+#include <map>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "InputBlocks.hpp"
+#include "Interfaces.h"
+#include "Slowdown.hpp"
+
+typedef struct {
+    double throughput;                      // Work done per instruction of the MIPS rating
+    double power;                           // Active core power against the P-state table
+} Efficiency_t;
+
+typedef struct {
+    CPUType_t cpu;
+    TaskClass_t task_class;
+    uint64_t instructions;                  // Instructions after the throughput multiplier
+    MachineId_t machine_id;
+    double factor;                          // Share of the instructions the simulator runs at the current P-state, as last set
+} EfficiencyTask_t;
+
+class Efficiency {
+public:
+    Efficiency()                {}
+    void         Init(string path, Slowdown * slowdown);
+    Efficiency_t Lookup(CPUType_t cpu, TaskClass_t task_class)  { return matrix[cpu][task_class]; }
+    void         PeriodicCheck(Time_t now);
+    void         Placed(TaskId_t task_id, MachineId_t machine_id);
+    double       PredictedSlowdown(TaskId_t task_id, MachineId_t machine_id, CPUPerformance_t p_state);
+    void         Report();
+    void         TaskArrived(Time_t now, TaskId_t task_id);
+    void         TasksCompleted(span<const TaskId_t> task_ids);
+private:
+    double Remaining(TaskId_t task_id, const EfficiencyTask_t & task);
+    void   Rescale(TaskId_t task_id, EfficiencyTask_t & task);
+    double Sensitivity(TaskId_t task_id, const EfficiencyTask_t & task);
+
+    Efficiency_t matrix[CPU_TYPES][TASK_CLASSES];
+    vector<double> sensitivity[TASK_CLASSES];   // Share that slows with the clock by phase, 1 is fully compute bound
+    double energy_per_instruction[CPU_TYPES];   // Active core energy at P0 in microjoules, from the first machine of the type
+    vector<TaskClassSpec_t> classes;
+    map<TaskId_t, EfficiencyTask_t> tasks;
+    set<TaskId_t> placed;                   // Running tasks whose machine is known
+    Slowdown * slowdown;
+    uint64_t rescales = 0;
+    uint64_t unclassified = 0;
+};
+
+#endif /* Efficiency_hpp */
@@ -0,0 +1,220 @@
+//
+//  Elastic.cpp
+//  CloudSim
+//
+
+#include <sstream>
+
+#include "Elastic.hpp"
+#include "Internal_Interfaces.h"
+
+static double ToKWHour(double microjoules) {
+    return microjoules / 3600000000000.0;
+}
+
+void Elastic::Init(const vector<ElasticPool_t> & pools, double burst_load, Time_t idle_time, double energy_price) {
+    this->pools = pools;
+    this->burst_load = burst_load;
+    this->idle_time = idle_time;
+    this->energy_price = energy_price;
+    for(auto & pool: pools) {
+        if(pool.shape >= Machine_GetTotal())
+            ThrowException("Elastic::Init(): No machine to copy the pool shape from, machine ", pool.shape);
+    }
+}
+
+double Elastic::Load(MachineId_t machine_id) {
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    return double(info.active_tasks) / info.num_cpus;
+}
+
+int Elastic::Pick(CPUType_t cpu, bool external) {
+    // Least loaded machine that is up, either on premises or at the burst provider
+    int best = -1;
+    double best_load = 0;
+    for(unsigned i = 0; i < Machine_GetTotal(); i++) {
+        MachineId_t machine_id = MachineId_t(i);
+        auto it = added.find(machine_id);
+        bool burst = it != added.end() && pools[provisioned[it->second].pool].external;
+        if(burst != external || retired.count(machine_id) || Machine_GetCPUType(machine_id) != cpu || Machine_GetInfo(machine_id).s_state != S0)
+            continue;
+        double load = Load(machine_id);
+        if(best < 0 || load < best_load) {
+            best = int(i);
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+bool Elastic::Provision(Time_t now, unsigned pool) {
+    unsigned live = 0;
+    for(auto & machine: provisioned) {
+        if(machine.pool == pool && !machine.retired)
+            live++;
+    }
+    if(pool >= pools.size() || live >= pools[pool].limit)
+        return false;
+    provisioned.push_back(ElasticMachine_t{pool, 0, false, false, now, 0, 0, 0, 0});
+    ScheduleSchedulerTimer(now + pools[pool].provisioning, ELASTIC_TIMER_FLAG | (provisioned.size() - 1));
+    SimOutput("Elastic::Provision(): Requested a machine of pool " + to_string(pool) + " at " + to_string(now), 2);
+    return true;
+}
+
+void Elastic::Ready(Time_t now, unsigned request) {
+    ElasticMachine_t & machine = provisioned[request];
+    MachineInfo_t shape = Machine_GetInfo(pools[machine.pool].shape);
+    Machine_Add(shape.memory_size, shape.num_cpus, shape.s_states, shape.c_states, shape.p_states, shape.performance, shape.gpus, shape.cpu);
+    machine.machine_id = MachineId_t(Machine_GetTotal() - 1);
+    machine.ready = true;
+    machine.idle_since = now;
+    // The simulator charges an added machine from the start of the run, the ledger starts it from here
+    machine.energy_base = Machine_GetEnergy(machine.machine_id);
+    added[machine.machine_id] = request;
+    SimOutput("Elastic::Ready(): Machine " + to_string(machine.machine_id) + " of pool " + to_string(machine.pool) + " up at " + to_string(now), 2);
+}
+
+bool Elastic::Retire(Time_t now, MachineId_t machine_id) {
+    if(retired.count(machine_id))
+        return false;
+    auto it = added.find(machine_id);
+    if(Machine_GetInfo(machine_id).active_tasks || (it != added.end() && provisioned[it->second].pending))
+        return false;
+    for(auto vm = vms.begin(); vm != vms.end(); ) {
+        if(vm->first.first == machine_id) {
+            VM_Shutdown(vm->second);
+            vm = vms.erase(vm);
+        }
+        else
+            vm++;
+    }
+    Machine_SetState(machine_id, S5);
+    retired.insert(machine_id);
+    if(it != added.end()) {
+        provisioned[it->second].retired = true;
+        provisioned[it->second].retired_at = now;
+    }
+    SimOutput("Elastic::Retire(): Machine " + to_string(machine_id) + " retired at " + to_string(now), 2);
+    return true;
+}
+
+void Elastic::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    CPUType_t cpu = RequiredCPUType(task_id);
+    int machine_id = Pick(cpu, false);
+    bool burst = false;
+    if(machine_id < 0 || Load(MachineId_t(machine_id)) >= burst_load) {
+        int external = Pick(cpu, true);
+        if(external >= 0) {
+            machine_id = external;
+            burst = true;
+        }
+    }
+    if(machine_id < 0)
+        ThrowException("Elastic::NewTask(): No machine up for task ", task_id);
+
+    VMType_t vm_type = RequiredVMType(task_id);
+    auto key = make_pair(MachineId_t(machine_id), vm_type);
+    auto vm = vms.find(key);
+    if(vm == vms.end()) {
+        VMId_t vm_id = VM_Create(vm_type, cpu);
+        VM_Attach(vm_id, MachineId_t(machine_id));
+        vm = vms.insert({key, vm_id}).first;
+    }
+    if(!burst) {
+        PlaceTask(vm->second, task_id, priority);
+        return;
+    }
+
+    burst_tasks++;
+    unsigned request = added[MachineId_t(machine_id)];
+    ElasticMachine_t & machine = provisioned[request];
+    machine.idle_since = 0;
+    Time_t latency = pools[machine.pool].latency;
+    if(!latency) {
+        PlaceTask(vm->second, task_id, priority);
+        return;
+    }
+    // The task reaches the provider only after the latency, it is held until then
+    machine.pending++;
+    delayed[task_id] = DelayedTask_t{vm->second, priority, request};
+    ScheduleSchedulerTimer(now + latency, ELASTIC_TIMER_FLAG | ELASTIC_TASK_FLAG | task_id);
+}
+
+void Elastic::TimerExpired(Time_t now, uint64_t cookie) {
+    if(!(cookie & ELASTIC_TASK_FLAG)) {
+        Ready(now, unsigned(cookie & ~ELASTIC_TIMER_FLAG));
+        return;
+    }
+    TaskId_t task_id = TaskId_t(cookie & ~(ELASTIC_TIMER_FLAG | ELASTIC_TASK_FLAG));
+    auto it = delayed.find(task_id);
+    if(it == delayed.end())
+        return;
+    PlaceTask(it->second.vm_id, task_id, it->second.priority);
+    provisioned[it->second.request].pending--;
+    delayed.erase(it);
+}
+
+void Elastic::PeriodicCheck(Time_t now) {
+    for(unsigned pool = 0; pool < pools.size(); pool++) {
+        if(!pools[pool].external)
+            continue;
+        // Burst capacity is requested while every machine of the class on premises is above the burst load,
+        // one machine at a time so a burst does not request a machine on every check
+        bool booting = false;
+        for(auto & machine: provisioned)
+            booting = booting || (machine.pool == pool && !machine.ready);
+        int least = Pick(Machine_GetCPUType(pools[pool].shape), false);
+        if(!booting && least >= 0 && Load(MachineId_t(least)) >= burst_load)
+            Provision(now, pool);
+    }
+
+    for(auto & machine: provisioned) {
+        if(!machine.ready || machine.retired || !pools[machine.pool].external)
+            continue;
+        if(Machine_GetInfo(machine.machine_id).active_tasks || machine.pending)
+            machine.idle_since = 0;
+        else if(!machine.idle_since)
+            machine.idle_since = now;
+        else if(now - machine.idle_since >= idle_time)
+            Retire(now, machine.machine_id);
+    }
+}
+
+void Elastic::Report(Time_t now) {
+    // Burst machines are billed by the hour and their energy is the provider's, every other machine is metered
+    double metered = 0;
+    for(unsigned i = 0; i < Machine_GetTotal(); i++) {
+        auto it = added.find(MachineId_t(i));
+        if(it == added.end()) {
+            metered += double(Machine_GetEnergy(MachineId_t(i)));
+            continue;
+        }
+        ElasticMachine_t & machine = provisioned[it->second];
+        if(!pools[machine.pool].external)
+            metered += double(Machine_GetEnergy(machine.machine_id) - machine.energy_base);
+    }
+
+    double hours = 0, spend = 0;
+    unsigned retirements = 0;
+    for(unsigned i = 0; i < provisioned.size(); i++) {
+        ElasticMachine_t & machine = provisioned[i];
+        double lifetime = double((machine.retired ? machine.retired_at : now) - machine.requested) / 3600000000.0;
+        hours += lifetime;
+        spend += lifetime * pools[machine.pool].cost_per_hour;
+        retirements += machine.retired;
+        ostringstream line;
+        line << "Elastic::Report(): Request " << i << " pool " << machine.pool << " machine " << (machine.ready ? to_string(machine.machine_id) : "not up")
+             << " provisioned for " << lifetime << " hours";
+        SimOutput(line.str(), 1);
+    }
+    double energy_cost = ToKWHour(metered) * energy_price;
+    cout << "Elastic: " << provisioned.size() << " machines provisioned, " << retirements << " retired, "
+         << burst_tasks << " tasks sent to burst capacity" << endl;
+    cout << "Elastic: metered energy " << ToKWHour(metered) << "KW-Hour ($" << energy_cost << "), provisioned machine time "
+         << hours << " hours ($" << spend << "), total cost $" << energy_cost + spend << endl;
+}
+
+void Elastic::Shutdown() {
+    for(auto & vm: vms)
+        VM_Shutdown(vm.second);
+}
@@ -0,0 +1,84 @@
+//
+//  Elastic.hpp
+//  CloudSim
+//
+//  Elastic cluster. Machines of a configured pool are added at runtime,
+//  after the pool's provisioning delay, and drained machines are retired
+//  to S5 and left out of placement from then on. A pool can be an external
+//  burst provider: its machines are billed by the hour instead of metered,
+//  and a task placed on one starts only after the provider's latency.
+//  Placement sends a task to the least loaded machine on premises, unless
+//  every one of them is above the burst load, in which case it goes to a
+//  burst machine. The periodic check provisions burst capacity while the
+//  premises are overloaded and retires burst machines that stay idle.
+//  The report puts the metered energy and the burst spend in one cost.
+//
+
+#ifndef Elastic_hpp
+#define Elastic_hpp
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "Interfaces.h"
+
+#define ELASTIC_TIMER_FLAG      (uint64_t(1) << 61) // Marks the timer cookies of provisioning and of burst task starts
+#define ELASTIC_TASK_FLAG       (uint64_t(1) << 60) // With ELASTIC_TIMER_FLAG: a burst task whose latency has elapsed
+
+typedef struct {
+    MachineId_t shape;                      // Machine whose class the new machines copy
+    Time_t provisioning;                    // Delay between the request and the machine being up
+    Time_t latency;                         // Delay before a task placed on a machine of the pool starts
+    double cost_per_hour;                   // Spend while provisioned, in dollars
+    bool external;                          // Burst provider capacity, billed instead of metered
+    unsigned limit;                         // Machines of the pool provisioned at once, at most
+} ElasticPool_t;
+
+typedef struct {
+    unsigned pool;
+    MachineId_t machine_id;
+    bool ready;
+    bool retired;
+    Time_t requested;                       // Billing starts at the request
+    Time_t idle_since;                      // Start of the current idle stretch, 0 while busy
+    Time_t retired_at;
+    uint64_t energy_base;                   // Energy the simulator charged to the machine before it existed
+    unsigned pending;                       // Tasks held for the provider latency
+} ElasticMachine_t;
+
+typedef struct {
+    VMId_t vm_id;
+    Priority_t priority;
+    unsigned request;                       // Request of the burst machine the task goes to
+} DelayedTask_t;
+
+class Elastic {
+public:
+    Elastic()                   {}
+    void Init(const vector<ElasticPool_t> & pools, double burst_load, Time_t idle_time, double energy_price);
+    void NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void PeriodicCheck(Time_t now);
+    bool Provision(Time_t now, unsigned pool);
+    void Report(Time_t now);
+    bool Retire(Time_t now, MachineId_t machine_id);
+    void Shutdown();
+    void TimerExpired(Time_t now, uint64_t cookie);
+private:
+    double Load(MachineId_t machine_id);
+    int    Pick(CPUType_t cpu, bool external);
+    void   Ready(Time_t now, unsigned request);
+
+    vector<ElasticPool_t> pools;
+    double burst_load;                      // Tasks per core on premises above which tasks go to burst machines
+    Time_t idle_time;                       // Idle time after which a burst machine is retired
+    double energy_price;                    // Dollars per KW-Hour of metered energy
+    vector<ElasticMachine_t> provisioned;   // Every machine requested, in request order
+    map<MachineId_t, unsigned> added;       // Request of every machine that was added
+    set<MachineId_t> retired;
+    map<TaskId_t, DelayedTask_t> delayed;   // Burst tasks waiting for the provider latency
+    map<pair<MachineId_t, VMType_t>, VMId_t> vms;  // One VM per machine and VM type, created on first placement
+    uint64_t burst_tasks = 0;
+};
+
+#endif /* Elastic_hpp */
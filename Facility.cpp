@@ -0,0 +1,89 @@
+//
+//  Facility.cpp
+//  CloudSim
+//
+
+#include "Facility.hpp"
+#include "InputBlocks.hpp"
+
+static double ToKWHour(double microjoules) {
+    return microjoules / 3600000000000.0;
+}
+
+void Facility::Init(Time_t now, const FacilityConfig_t & config, string path) {
+    this->config = config;
+    last_update = now;
+    for(unsigned i = 0; i < Machine_GetTotal(); i++)
+        machine_energy.push_back(Machine_GetEnergy(MachineId_t(i)));
+    if(path.empty())
+        return;
+    for(auto & block: ReadInputBlocks(path)) {
+        if(block.type != "ambient temperature")
+            continue;
+        ambient_times = ParseBracketedValues(block.fields["Times"]);
+        ambient_temperatures = ParseBracketedValues(block.fields["Temperatures"]);
+        if(ambient_times.empty() || ambient_times.size() != ambient_temperatures.size())
+            ThrowException("Facility::Init(): The ambient temperature needs as many times as temperatures, got ", unsigned(ambient_times.size()));
+    }
+}
+
+double Facility::Ambient(Time_t now) {
+    // Linear between the points of the series, held flat before the first and after the last
+    if(ambient_times.empty())
+        return config.ambient;
+    double time = double(now);
+    if(time <= ambient_times.front())
+        return ambient_temperatures.front();
+    for(unsigned i = 1; i < ambient_times.size(); i++) {
+        if(time <= ambient_times[i]) {
+            double position = (time - ambient_times[i - 1]) / (ambient_times[i] - ambient_times[i - 1]);
+            return ambient_temperatures[i - 1] + (ambient_temperatures[i] - ambient_temperatures[i - 1]) * position;
+        }
+    }
+    return ambient_temperatures.back();
+}
+
+double Facility::CoolingPower(double it_power, double ambient) {
+    if(ambient <= config.free_cooling_limit)
+        return it_power * config.fan_share;
+    double cop = max(1.0, config.chiller_cop - config.cop_slope * (ambient - config.free_cooling_limit));
+    return it_power / cop;
+}
+
+void Facility::PeriodicCheck(Time_t now) {
+    double elapsed = double(now - last_update);
+    if(elapsed <= 0)
+        return;
+    // Machines added while the simulation runs are metered from their first check
+    double it = 0;
+    for(unsigned i = 0; i < Machine_GetTotal(); i++) {
+        uint64_t energy = Machine_GetEnergy(MachineId_t(i));
+        if(i < machine_energy.size())
+            it += double(energy - machine_energy[i]);
+        else
+            machine_energy.push_back(energy);
+        machine_energy[i] = energy;
+    }
+    // Microjoules per microsecond are watts
+    double it_power = it / elapsed;
+    double ambient = Ambient(now);
+    double cooling = CoolingPower(it_power, ambient);
+    double distribution = it_power * config.distribution_loss;
+    it_energy += it;
+    cooling_energy += cooling * elapsed;
+    distribution_energy += distribution * elapsed;
+    fixed_energy += config.fixed_load * elapsed;
+    if(ambient <= config.free_cooling_limit)
+        free_cooling_time += elapsed / 1000000;
+    peak_power = max(peak_power, it_power + cooling + distribution + config.fixed_load);
+    last_update = now;
+}
+
+void Facility::Report(Time_t now) {
+    PeriodicCheck(now);
+    double facility = it_energy + cooling_energy + distribution_energy + fixed_energy;
+    cout << "Facility: IT " << ToKWHour(it_energy) << "KW-Hour, cooling " << ToKWHour(cooling_energy) << "KW-Hour, power distribution "
+         << ToKWHour(distribution_energy) << "KW-Hour, fixed " << ToKWHour(fixed_energy) << "KW-Hour" << endl;
+    cout << "Facility: total " << ToKWHour(facility) << "KW-Hour, effective PUE " << (it_energy > 0 ? facility / it_energy : 0)
+         << ", peak " << peak_power / 1000 << "KW, " << free_cooling_time << "s on free cooling" << endl;
+}
@@ -0,0 +1,57 @@
+//
+//  Facility.hpp
+//  CloudSim
+//
+//  Facility overhead on top of the IT energy. Cooling runs on outside air
+//  while the ambient temperature is below the free cooling limit, costing
+//  only fan power in proportion to the IT load. Above it the chillers take
+//  over, and their coefficient of performance drops as the ambient gets
+//  hotter. Power distribution loses a share of the IT load and the rest of
+//  the building draws a fixed load. The ambient temperature follows a time
+//  series from the input, or stays constant without one. The facility
+//  power is integrated on every periodic check next to the IT energy the
+//  machines report, which gives the total facility energy and the
+//  effective PUE.
+//
+
+#ifndef Facility_hpp
+#define Facility_hpp
+
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    double ambient;                         // Outside temperature without a time series, in Celsius
+    double free_cooling_limit;              // Ambient temperature up to which outside air is enough
+    double fan_share;                       // Fan power as a share of the IT power while cooling on outside air
+    double chiller_cop;                     // Coefficient of performance of the chillers at the free cooling limit
+    double cop_slope;                       // Loss of coefficient of performance per Celsius above the limit
+    double distribution_loss;               // Share of the IT power lost in UPS and power distribution
+    double fixed_load;                      // Lights, offices and the rest of the building, in watts
+} FacilityConfig_t;
+
+class Facility {
+public:
+    Facility()                  {}
+    double Ambient(Time_t now);
+    double CoolingPower(double it_power, double ambient);
+    void   Init(Time_t now, const FacilityConfig_t & config, string path);
+    void   PeriodicCheck(Time_t now);
+    void   Report(Time_t now);
+private:
+    FacilityConfig_t config;
+    vector<double> ambient_times;           // Time series of the ambient temperature, in microseconds
+    vector<double> ambient_temperatures;
+    Time_t last_update;
+    vector<uint64_t> machine_energy;        // Energy of every machine at last_update
+    double it_energy = 0;                   // All in microjoules
+    double cooling_energy = 0;
+    double distribution_energy = 0;
+    double fixed_energy = 0;
+    double free_cooling_time = 0;           // Seconds cooled on outside air
+    double peak_power = 0;                  // Highest facility power over one check, in watts
+};
+
+#endif /* Facility_hpp */
@@ -0,0 +1,316 @@
+//
+//  Federation.cpp
+//  CloudSim
+//
+
+#include <sstream>
+
+#include "Federation.hpp"
+
+static double ToKWHour(double microjoules) {
+    return microjoules / 3600000000000.0;
+}
+
+void Federation::Init(string path, double spill_load) {
+    this->spill_load = spill_load;
+    vector<InputBlock_t> blocks = ReadInputBlocks(path);
+    classes = ReadTaskClasses(blocks);
+
+    // Machine ids follow the order of the machine classes in the input
+    vector<pair<unsigned, unsigned> > class_machines;
+    unsigned first = 0;
+    for(auto & block: blocks) {
+        if(block.type != "machine class")
+            continue;
+        unsigned count = unsigned(stoul(block.fields["Number of machines"]));
+        class_machines.push_back({first, count});
+        first += count;
+    }
+    machine_site.assign(Machine_GetTotal(), -1);
+    for(auto & block: blocks) {
+        if(block.type != "site")
+            continue;
+        auto fields = block.fields;
+        Site_t site = {fields["Name"], {}, {}, {}, {}, ParseBracketedValues(fields["Latency"]), ParseBracketedValues(fields["Bandwidth"]),
+                       fields.count("Egress cost") ? stod(fields["Egress cost"]) : 0, 0, 0, 0, 0, 0};
+        for(auto machine_class: ParseBracketedValues(fields["Machine classes"])) {
+            if(unsigned(machine_class) >= class_machines.size())
+                ThrowException("Federation::Init(): No machine class ", unsigned(machine_class));
+            auto [start, count] = class_machines[unsigned(machine_class)];
+            for(unsigned i = start; i < start + count && i < machine_site.size(); i++) {
+                site.machines.push_back(MachineId_t(i));
+                machine_site[i] = int(sites.size());
+            }
+        }
+        if(fields.count("Task classes")) {
+            for(auto task_class: ParseBracketedValues(fields["Task classes"]))
+                site.task_classes.insert(unsigned(task_class));
+        }
+        if(fields.count("Prices")) {
+            site.price_times = ParseBracketedValues(fields["Price times"]);
+            site.prices = ParseBracketedValues(fields["Prices"]);
+        }
+        if(site.prices.empty() || site.price_times.size() != site.prices.size())
+            ThrowException("Federation::Init(): Site " + site.name + " needs as many price times as prices, got ", unsigned(site.price_times.size()));
+        sites.push_back(site);
+    }
+    if(sites.empty())
+        ThrowException("Federation::Init(): No site in ", path);
+    for(unsigned from = 0; from < sites.size(); from++) {
+        if(sites[from].latency.size() != sites.size() || sites[from].bandwidth.size() != sites.size())
+            ThrowException("Federation::Init(): Latency and bandwidth need one entry per site, site ", sites[from].name);
+        for(unsigned to = 0; to < sites.size(); to++) {
+            if(to != from && sites[from].bandwidth[to] <= 0)
+                ThrowException("Federation::Init(): No bandwidth from site " + sites[from].name + " to site ", sites[to].name);
+        }
+    }
+    for(unsigned i = 0; i < Machine_GetTotal(); i++)
+        machine_energy.push_back(Machine_GetEnergy(MachineId_t(i)));
+}
+
+double Federation::Price(unsigned site, Time_t now) {
+    // Every price holds until the next time of the series
+    const Site_t & target = sites[site];
+    double price = target.prices.front();
+    for(unsigned i = 0; i < target.price_times.size() && target.price_times[i] <= double(now); i++)
+        price = target.prices[i];
+    return price;
+}
+
+Time_t Federation::TransferTime(unsigned from, unsigned to, unsigned memory) {
+    if(from == to)
+        return 0;
+    return Time_t(sites[from].latency[to] + double(memory) / sites[from].bandwidth[to] * 1000000);
+}
+
+double Federation::Load(MachineId_t machine_id) {
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    return double(info.active_tasks) / info.num_cpus;
+}
+
+int Federation::LeastLoaded(unsigned site, CPUType_t cpu) {
+    int best = -1;
+    double best_load = 0;
+    for(auto machine_id: sites[site].machines) {
+        if(Machine_GetCPUType(machine_id) != cpu || Machine_GetInfo(machine_id).s_state != S0)
+            continue;
+        double load = Load(machine_id);
+        if(best < 0 || load < best_load) {
+            best = int(machine_id);
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+int Federation::Offload(Federation & federation, Time_t now, VMId_t vm_id) {
+    VMInfo_t info = VM_GetInfo(vm_id);
+    int from = federation.machine_site[info.machine_id];
+    if(info.active_tasks.empty() || from < 0 || federation.Load(info.machine_id) <= federation.spill_load)
+        return -1;
+    unsigned memory = VM_MEMORY_OVERHEAD;
+    Time_t deadline = 0;
+    for(auto task_id: info.active_tasks) {
+        memory += GetTaskMemory(task_id);
+        Time_t target = GetTaskInfo(task_id).target_completion;
+        deadline = deadline ? min(deadline, target) : target;
+    }
+
+    // The cheapest other site whose least loaded machine stays within the spill load with the tasks of the VM
+    int best = -1;
+    double best_price = 0;
+    for(unsigned site = 0; site < federation.sites.size(); site++) {
+        int machine_id = federation.LeastLoaded(site, info.cpu);
+        if(int(site) == from || machine_id < 0)
+            continue;
+        MachineInfo_t target = Machine_GetInfo(MachineId_t(machine_id));
+        if(double(target.active_tasks + info.active_tasks.size()) / target.num_cpus > federation.spill_load)
+            continue;
+        if(now + federation.TransferTime(unsigned(from), site, memory) >= deadline)
+            continue;
+        double price = federation.Price(site, now);
+        if(best < 0 || price < best_price) {
+            best = machine_id;
+            best_price = price;
+        }
+    }
+    return best;
+}
+
+unsigned Federation::GeoRoute(Federation & federation, Time_t now, TaskId_t task_id, unsigned origin) {
+    CPUType_t cpu = RequiredCPUType(task_id);
+    int home = federation.LeastLoaded(origin, cpu);
+    if(home >= 0 && federation.Load(MachineId_t(home)) < federation.spill_load)
+        return origin;
+
+    // Among the other sites with room, the cheapest energy now, then the nearest
+    TaskInfo_t info = GetTaskInfo(task_id);
+    unsigned best = origin;
+    double best_price = 0;
+    Time_t best_transfer = 0;
+    for(unsigned site = 0; site < federation.sites.size(); site++) {
+        int machine_id = federation.LeastLoaded(site, cpu);
+        if(site == origin || machine_id < 0 || federation.Load(MachineId_t(machine_id)) >= federation.spill_load)
+            continue;
+        // A transfer that alone takes the task past its deadline is not worth making
+        Time_t transfer = federation.TransferTime(origin, site, info.required_memory);
+        if(now + transfer >= info.target_completion)
+            continue;
+        double price = federation.Price(site, now);
+        if(best == origin || price < best_price || (price == best_price && transfer < best_transfer)) {
+            best = site;
+            best_price = price;
+            best_transfer = transfer;
+        }
+    }
+    return best;
+}
+
+void Federation::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    int spec = MatchTaskClass(classes, now, task_id);
+    unsigned origin = 0;
+    for(unsigned site = 0; site < sites.size(); site++) {
+        if(spec >= 0 && sites[site].task_classes.count(unsigned(spec)))
+            origin = site;
+    }
+    sites[origin].originated++;
+
+    CPUType_t cpu = RequiredCPUType(task_id);
+    unsigned site = policy(*this, now, task_id, origin);
+    int machine_id = LeastLoaded(site, cpu);
+    // A site without a machine for the task leaves it at home, or at the first site that has one
+    for(unsigned candidate = 0; machine_id < 0 && candidate <= sites.size(); candidate++) {
+        site = candidate == 0 ? origin : candidate - 1;
+        machine_id = LeastLoaded(site, cpu);
+    }
+    if(machine_id < 0)
+        ThrowException("Federation::NewTask(): No site has a machine for task ", task_id);
+
+    if(site == origin) {
+        PlaceTask(PlacementVM(MachineId_t(machine_id), RequiredVMType(task_id), cpu), task_id, priority);
+        return;
+    }
+
+    unsigned memory = GetTaskMemory(task_id);
+    Time_t transfer = TransferTime(origin, site, memory);
+    sites[origin].exported++;
+    sites[site].imported++;
+    transfer_time += double(transfer);
+    egress_cost += double(memory) / 1024 * sites[origin].egress_cost;
+    transfers[task_id] = Transfer_t{MachineId_t(machine_id), priority};
+    ScheduleSchedulerTimer(now + transfer, FEDERATION_TIMER_FLAG | task_id);
+}
+
+VMId_t Federation::PlacementVM(MachineId_t machine_id, VMType_t vm_type, CPUType_t cpu) {
+    auto key = make_pair(machine_id, vm_type);
+    auto vm = vms.find(key);
+    if(vm == vms.end()) {
+        VMId_t vm_id = VM_Create(vm_type, cpu);
+        VM_Attach(vm_id, machine_id);
+        created.push_back(vm_id);
+        vm = vms.insert({key, vm_id}).first;
+    }
+    return vm->second;
+}
+
+void Federation::Migrate(Time_t now, VMId_t vm_id, MachineId_t machine_id) {
+    VMInfo_t info = VM_GetInfo(vm_id);
+    // New tasks must not land on the VM while it moves, the next one for its old machine gets a fresh VM
+    auto vm = vms.find({info.machine_id, info.vm_type});
+    if(vm != vms.end() && vm->second == vm_id)
+        vms.erase(vm);
+    migrating.insert(vm_id);
+    int from = machine_site[info.machine_id], to = machine_id < machine_site.size() ? machine_site[machine_id] : -1;
+    if(from == to || from < 0 || to < 0) {
+        VM_Migrate(vm_id, machine_id);
+        return;
+    }
+    // The memory image crosses the inter-site link first, the VM keeps running at the source meanwhile
+    unsigned memory = VM_MEMORY_OVERHEAD;
+    for(auto task_id: info.active_tasks)
+        memory += GetTaskMemory(task_id);
+    egress_cost += double(memory) / 1024 * sites[from].egress_cost;
+    migrations.push_back({vm_id, machine_id});
+    ScheduleSchedulerTimer(now + TransferTime(unsigned(from), unsigned(to), memory), FEDERATION_TIMER_FLAG | FEDERATION_MIGRATION_FLAG | (migrations.size() - 1));
+}
+
+void Federation::TimerExpired(Time_t now, uint64_t cookie) {
+    if(cookie & FEDERATION_MIGRATION_FLAG) {
+        auto [vm_id, machine_id] = migrations[cookie & ~(FEDERATION_TIMER_FLAG | FEDERATION_MIGRATION_FLAG)];
+        VMInfo_t info = VM_GetInfo(vm_id);
+        if(info.active_tasks.empty()) {
+            // Its tasks finished while the image crossed, so the VM stays and takes tasks again
+            migrating.erase(vm_id);
+            vms.insert({{info.machine_id, info.vm_type}, vm_id});
+            abandoned++;
+            return;
+        }
+        VM_Migrate(vm_id, machine_id);
+        return;
+    }
+    TaskId_t task_id = TaskId_t(cookie & ~FEDERATION_TIMER_FLAG);
+    auto it = transfers.find(task_id);
+    if(it == transfers.end())
+        return;
+    PlaceTask(PlacementVM(it->second.machine_id, RequiredVMType(task_id), RequiredCPUType(task_id)), task_id, it->second.priority);
+    transfers.erase(it);
+}
+
+void Federation::MigrationComplete(VMId_t vm_id) {
+    if(!migrating.erase(vm_id))
+        return;
+    // The VM takes new tasks at its new machine, unless that machine already has one of its type
+    VMInfo_t info = VM_GetInfo(vm_id);
+    vms.insert({{info.machine_id, info.vm_type}, vm_id});
+}
+
+void Federation::PeriodicCheck(Time_t now) {
+    // Energy is priced at the site's price when it is drawn. Machines added while the simulation runs belong to no site
+    for(unsigned i = 0; i < Machine_GetTotal(); i++) {
+        uint64_t energy = Machine_GetEnergy(MachineId_t(i));
+        if(i >= machine_energy.size()) {
+            machine_energy.push_back(energy);
+            machine_site.push_back(-1);
+            continue;
+        }
+        double consumed = double(energy - machine_energy[i]);
+        machine_energy[i] = energy;
+        if(machine_site[i] < 0)
+            continue;
+        Site_t & site = sites[machine_site[i]];
+        site.energy += consumed;
+        site.energy_cost += ToKWHour(consumed) * Price(unsigned(machine_site[i]), now);
+    }
+    // One migration per check, so the loads the policy sees are not stale by several migrations in flight
+    for(auto vm_id: created) {
+        if(migrating.count(vm_id))
+            continue;
+        int machine_id = migration_policy(*this, now, vm_id);
+        if(machine_id >= 0) {
+            Migrate(now, vm_id, MachineId_t(machine_id));
+            break;
+        }
+    }
+}
+
+void Federation::Report() {
+    uint64_t exported = 0;
+    double energy_cost = 0;
+    for(auto & site: sites) {
+        cout << "Federation: site " << site.name << " " << site.machines.size() << " machines, " << site.originated << " tasks originated, "
+             << site.exported << " sent away, " << site.imported << " taken in, " << ToKWHour(site.energy) << "KW-Hour ($" << site.energy_cost << ")" << endl;
+        exported += site.exported;
+        energy_cost += site.energy_cost;
+    }
+    cout << "Federation: " << exported << " tasks placed away from their site, mean transfer " << (exported ? transfer_time / exported / 1000 : 0)
+         << "ms, egress $" << egress_cost << ", energy $" << energy_cost << ", " << migrations.size() << " migrations between sites, "
+         << abandoned << " of them dropped when the VM emptied in transit" << endl;
+}
+
+void Federation::Shutdown() {
+    // A VM still crossing between sites at the end is left to the simulator
+    for(auto vm_id: created) {
+        if(!migrating.count(vm_id))
+            VM_Shutdown(vm_id);
+    }
+}
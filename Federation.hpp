@@ -0,0 +1,103 @@
+//
+//  Federation.hpp
+//  CloudSim
+//
+//  Several datacenter sites in one run. The input gives a "site:" block per
+//  site, naming the machine classes it holds, the task classes that
+//  originate there, its energy price series, its egress cost, and its row
+//  of the inter-site latency and bandwidth matrices. Every arrival starts
+//  at its origin site, and a site policy picks the site it runs at. The
+//  default policy keeps the task at home unless every machine there is
+//  above the spill load, and otherwise sends it to the cheapest site with
+//  room. A task sent to another site waits for the latency plus the
+//  transfer of its memory, and its memory is charged as egress. VM
+//  migrations between sites wait for the same transfer before the
+//  simulator starts its own migration. A migration policy is asked about
+//  every VM at each periodic check. The default one moves the VM off a
+//  machine above the spill load to the cheapest other site that can take
+//  its tasks and that the image reaches before their earliest deadline.
+//  A migrating VM takes no new tasks. A task that arrives for it meanwhile
+//  goes to a fresh VM on the same machine.
+//
+
+#ifndef Federation_hpp
+#define Federation_hpp
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "InputBlocks.hpp"
+#include "Interfaces.h"
+
+#define FEDERATION_TIMER_FLAG       (uint64_t(1) << 59) // Marks the timer cookies of transfers between sites
+#define FEDERATION_MIGRATION_FLAG   (uint64_t(1) << 58) // With FEDERATION_TIMER_FLAG: a VM migration rather than a task
+
+typedef struct {
+    string name;
+    vector<MachineId_t> machines;
+    set<unsigned> task_classes;             // Task classes, in input order, that originate at the site
+    vector<double> price_times;             // Energy price series, times in microseconds
+    vector<double> prices;                  // Dollars per KW-Hour
+    vector<double> latency;                 // One-way latency to every site, in microseconds
+    vector<double> bandwidth;               // MB per second to every site
+    double egress_cost;                     // Dollars per GB leaving the site
+    uint64_t originated;
+    uint64_t exported;
+    uint64_t imported;
+    double energy;                          // Microjoules since the start
+    double energy_cost;
+} Site_t;
+
+typedef struct {
+    MachineId_t machine_id;
+    Priority_t priority;
+} Transfer_t;
+
+class Federation;
+typedef unsigned (*SitePolicy_t)(Federation & federation, Time_t now, TaskId_t task_id, unsigned origin);
+typedef int (*MigrationPolicy_t)(Federation & federation, Time_t now, VMId_t vm_id);   // Target machine, -1 to leave the VM
+
+class Federation {
+public:
+    Federation()                {}
+    const Site_t & GetSite(unsigned site)   { return sites[site]; }
+    unsigned GetTotalSites()                { return unsigned(sites.size()); }
+    void     Init(string path, double spill_load);
+    int      LeastLoaded(unsigned site, CPUType_t cpu);
+    double   Load(MachineId_t machine_id);
+    void     Migrate(Time_t now, VMId_t vm_id, MachineId_t machine_id);
+    void     MigrationComplete(VMId_t vm_id);
+    void     NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void     PeriodicCheck(Time_t now);
+    double   Price(unsigned site, Time_t now);
+    void     Report();
+    void     SetMigrationPolicy(MigrationPolicy_t policy)   { migration_policy = policy; }
+    void     SetPolicy(SitePolicy_t policy) { this->policy = policy; }
+    void     Shutdown();
+    void     TimerExpired(Time_t now, uint64_t cookie);
+    Time_t   TransferTime(unsigned from, unsigned to, unsigned memory);
+private:
+    static unsigned GeoRoute(Federation & federation, Time_t now, TaskId_t task_id, unsigned origin);
+    static int      Offload(Federation & federation, Time_t now, VMId_t vm_id);
+    VMId_t          PlacementVM(MachineId_t machine_id, VMType_t vm_type, CPUType_t cpu);
+
+    vector<Site_t> sites;
+    vector<int> machine_site;               // Site of every machine, -1 when no site holds it
+    vector<uint64_t> machine_energy;        // Energy of every machine at the last periodic check
+    vector<TaskClassSpec_t> classes;
+    double spill_load;                      // Tasks per core at home above which a task may leave its site
+    SitePolicy_t policy = GeoRoute;
+    MigrationPolicy_t migration_policy = Offload;
+    map<pair<MachineId_t, VMType_t>, VMId_t> vms;  // The VM new tasks go to per machine and VM type, created on first placement
+    vector<VMId_t> created;                 // Every VM, shut down at the end
+    set<VMId_t> migrating;                  // Out of vms until the simulator completes the migration
+    map<TaskId_t, Transfer_t> transfers;    // Tasks on their way to another site
+    vector<pair<VMId_t, MachineId_t> > migrations;  // Migrations between sites, by timer cookie
+    uint64_t abandoned = 0;                 // Migrations whose VM had no tasks left when the image arrived
+    double transfer_time = 0;               // Sum over the tasks sent to another site, in microseconds
+    double egress_cost = 0;
+};
+
+#endif /* Federation_hpp */
@@ -0,0 +1,87 @@
+//
+//  Flows.cpp
+//  CloudSim
+//
+
+#include "Flows.hpp"
+#include "Internal_Interfaces.h"
+
+#define MAX_FLOW_LOAD   0.95                // Cap on the utilization seen by the queueing model
+
+void Flows::Init(string path) {
+    classes = ReadTaskClasses(ReadInputBlocks(path));
+    for(auto & stats: sla)
+        stats = FlowSLA_t{0, 0};
+    core_time = 0;
+    random.seed(0);
+}
+
+void Flows::Refresh(VMId_t vm_id, Flow_t & flow) {
+    MachineInfo_t machine = Machine_GetInfo(VM_GetInfo(vm_id).machine_id);
+    flow.num_cpus = machine.num_cpus;
+    flow.active_tasks = machine.active_tasks;
+    flow.mips = machine.performance[machine.p_state];
+}
+
+bool Flows::Serve(Time_t now, TaskId_t task_id, VMId_t vm_id) {
+    TaskInfo_t task = GetTaskInfo(task_id);
+    int spec = MatchTaskClass(classes, now, task);
+    if(spec < 0 || classes[spec].task_class != WEB_REQUEST)
+        return false;
+    // Looking the VM and the machine up copies their vectors, so a flow keeps them between periodic checks
+    auto it = flows.find(vm_id);
+    if(it == flows.end()) {
+        it = flows.insert({vm_id, Flow_t{0, 0, 0, 0, 0, 0, 0, now}}).first;
+        Refresh(vm_id, it->second);
+    }
+    Flow_t & flow = it->second;
+    flow.requests++;
+    flow.instructions += double(task.total_instructions);
+
+    // Processor sharing: a fair share of a core, slowed down by the load of the flow itself
+    double service = double(task.total_instructions) / flow.mips;
+    double cores = flow.rate * flow.size / flow.mips;
+    double share = min(1.0, double(flow.num_cpus) / (flow.active_tasks + 1));
+    double load = min(MAX_FLOW_LOAD, cores / flow.num_cpus);
+    exponential_distribution<double> response((1 - load) * share / service);
+    core_time += service;
+    sla[task.required_sla].requests++;
+    if(now + Time_t(response(random)) <= task.target_completion) {
+        CompleteTask(task_id);
+        return true;
+    }
+    // The simulator judges the SLA at the time of CompleteTask, so a late request waits until its target has passed
+    sla[task.required_sla].violations++;
+    ScheduleSchedulerTimer(task.target_completion + 1, FLOWS_TIMER_FLAG | task_id);
+    return true;
+}
+
+void Flows::TimerExpired(Time_t now, uint64_t cookie) {
+    CompleteTask(TaskId_t(cookie & ~FLOWS_TIMER_FLAG));
+}
+
+void Flows::PeriodicCheck(Time_t now) {
+    for(auto & [vm_id, flow]: flows) {
+        Refresh(vm_id, flow);
+        if(now <= flow.last_update)
+            continue;
+        flow.rate = (flow.rate + double(flow.requests) / (now - flow.last_update)) / 2;
+        if(flow.requests)
+            flow.size = flow.instructions / flow.requests;
+        flow.requests = 0;
+        flow.instructions = 0;
+        flow.last_update = now;
+    }
+}
+
+void Flows::Report() {
+    uint64_t total = 0;
+    for(auto & stats: sla)
+        total += stats.requests;
+    cout << "Flows: " << total << " requests served in " << flows.size() << " flows, " << core_time / 1000000
+         << " core-s of their work is not in the energy report" << endl;
+    for(unsigned s = SLA0; s < SLA3; s++) {
+        if(sla[s].requests)
+            cout << "Flow SLA" << s << ": " << 100.0 * sla[s].violations / sla[s].requests << "% sampled" << endl;
+    }
+}
@@ -0,0 +1,64 @@
+//
+//  Flows.hpp
+//  CloudSim
+//
+//  Flow representation of high rate web requests. The arrivals that match a
+//  WEB_REQUEST task class of the input are not run as tasks: the requests
+//  sent to a VM form a flow, kept as an arrival rate and a mean request
+//  size. The response time of every request is sampled from a processor
+//  sharing queue at the machine's speed and load, as of the last periodic
+//  check. A request that meets its target is retired with CompleteTask as
+//  it arrives. One that misses it is retired by a timer once the target has
+//  passed, so the simulator's SLA report counts the sampled outcome of every
+//  request. The requests never reach a machine, which saves their VM_AddTask,
+//  their completion and their share of the machine timer events. Their
+//  work is not metered either, so the report gives the core time the flows
+//  stand for next to the energy that leaves out.
+//
+
+#ifndef Flows_hpp
+#define Flows_hpp
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "InputBlocks.hpp"
+
+#define FLOWS_TIMER_FLAG        (uint64_t(1) << 57) // Marks the timer cookies of requests retired after their target
+
+typedef struct {
+    unsigned num_cpus;                      // Machine of the VM, refreshed on the periodic check
+    unsigned active_tasks;
+    double mips;                            // Instructions per microsecond at the current P-state
+    uint64_t requests;                      // Since the last periodic check
+    double instructions;
+    double rate;                            // Requests per microsecond, smoothed over the periodic checks
+    double size;                            // Mean instructions per request
+    Time_t last_update;
+} Flow_t;
+
+typedef struct {
+    uint64_t requests;                      // Requests of every SLA served as flows
+    uint64_t violations;                    // SLA violations sampled from the flow model
+} FlowSLA_t;
+
+class Flows {
+public:
+    Flows()                     {}
+    void Init(string path);
+    void PeriodicCheck(Time_t now);
+    void Report();
+    bool Serve(Time_t now, TaskId_t task_id, VMId_t vm_id);
+    void TimerExpired(Time_t now, uint64_t cookie);
+private:
+    void Refresh(VMId_t vm_id, Flow_t & flow);
+
+    vector<TaskClassSpec_t> classes;
+    map<VMId_t, Flow_t> flows;
+    FlowSLA_t sla[NUM_SLAS];
+    double core_time;                       // Service time of the requests served as flows, in microseconds
+    mt19937_64 random;
+};
+
+#endif /* Flows_hpp */
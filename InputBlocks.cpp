@@ -0,0 +1,99 @@
+//
+//  InputBlocks.cpp
+//  CloudSim
+//
+
+#include <fstream>
+#include <sstream>
+
+#include "InputBlocks.hpp"
+
+const char * cpu_type_names[CPU_TYPES] = {"ARM", "POWER", "RISCV", "X86"};
+const char * task_type_names[TASK_CLASSES] = {"AI", "CRYPTO", "HPC", "STREAM", "WEB"};
+static const char * vm_names[] = {"LINUX", "LINUX_RT", "WIN", "AIX"};
+static const char * sla_names[] = {"SLA0", "SLA1", "SLA2", "SLA3"};
+
+static string Trim(const string & text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if(first == string::npos)
+        return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+vector<double> ParseBracketedValues(const string & text) {
+    string values = Trim(text);
+    if(values.size() < 2 || values.front() != '[' || values.back() != ']')
+        ThrowException("ParseBracketedValues(): Expected a list in brackets, got ", text);
+    vector<double> result;
+    istringstream items(values.substr(1, values.size() - 2));
+    string item;
+    while(getline(items, item, ','))
+        result.push_back(stod(item));
+    return result;
+}
+
+vector<InputBlock_t> ReadInputBlocks(string path) {
+    ifstream input(path);
+    if(!input)
+        ThrowException("ReadInputBlocks(): Cannot open ", path);
+    vector<InputBlock_t> blocks;
+    InputBlock_t block;
+    string line;
+    while(getline(input, line)) {
+        line = Trim(line);
+        if(line.empty() || line[0] == '#' || line == "{")
+            continue;
+        if(line == "}") {
+            blocks.push_back(block);
+            block = InputBlock_t{};
+            continue;
+        }
+        size_t colon = line.find(':');
+        if(colon == string::npos)
+            continue;
+        string key = Trim(line.substr(0, colon)), value = Trim(line.substr(colon + 1));
+        if(value.empty())
+            block.type = key;
+        else
+            block.fields[key] = value;
+    }
+    return blocks;
+}
+
+unsigned ParseName(const char * names[], unsigned count, const string & name, const string & key) {
+    for(unsigned i = 0; i < count; i++) {
+        if(name == names[i])
+            return i;
+    }
+    ThrowException("ParseName(): Unknown " + key + " ", name);
+    return 0;
+}
+
+vector<TaskClassSpec_t> ReadTaskClasses(const vector<InputBlock_t> & blocks) {
+    vector<TaskClassSpec_t> classes;
+    for(auto & block: blocks) {
+        if(block.type != "task class")
+            continue;
+        map<string, string> fields = block.fields;
+        // The last arrival of a class can land up to one inter-arrival time past its end
+        classes.push_back(TaskClassSpec_t{stoull(fields["Start time"]), stoull(fields["End time"]) + stoull(fields["Inter arrival"]),
+            VMType_t(ParseName(vm_names, 4, fields["VM type"], "VM type")), SLAType_t(ParseName(sla_names, 4, fields["SLA type"], "SLA type")),
+            CPUType_t(ParseName(cpu_type_names, CPU_TYPES, fields["CPU type"], "CPU type")), fields["GPU enabled"] == "yes",
+            unsigned(stoul(fields["Memory"])), TaskClass_t(ParseName(task_type_names, TASK_CLASSES, fields["Task type"], "task type"))});
+    }
+    return classes;
+}
+
+int MatchTaskClass(const vector<TaskClassSpec_t> & classes, Time_t now, TaskId_t task_id) {
+    return MatchTaskClass(classes, now, GetTaskInfo(task_id));
+}
+
+int MatchTaskClass(const vector<TaskClassSpec_t> & classes, Time_t now, const TaskInfo_t & info) {
+    for(unsigned i = 0; i < classes.size(); i++) {
+        const TaskClassSpec_t & spec = classes[i];
+        if(now >= spec.start && now <= spec.end && spec.vm_type == info.required_vm && spec.sla == info.required_sla
+           && spec.cpu == info.required_cpu && spec.gpu_capable == info.gpu_capable && spec.memory == info.required_memory)
+            return int(i);
+    }
+    return -1;
+}
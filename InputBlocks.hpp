@@ -0,0 +1,52 @@
+//
+//  InputBlocks.hpp
+//  CloudSim
+//
+//  Reader for the block format of the input files: a line naming the block
+//  type and ending in a colon, then "Key: value" lines between braces. The
+//  simulator skips the block types it does not know, so the scheduler
+//  extensions keep their settings in blocks of their own in the same file.
+//  The simulator does not expose the class of a task either, so arrivals
+//  are matched against the task classes of the input by their attributes
+//  and arrival window.
+//
+
+#ifndef InputBlocks_hpp
+#define InputBlocks_hpp
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+
+#define CPU_TYPES       4
+#define TASK_CLASSES    5
+
+typedef struct {
+    string type;
+    map<string, string> fields;
+} InputBlock_t;
+
+typedef struct {
+    Time_t start;
+    Time_t end;
+    VMType_t vm_type;
+    SLAType_t sla;
+    CPUType_t cpu;
+    bool gpu_capable;
+    unsigned memory;
+    TaskClass_t task_class;
+} TaskClassSpec_t;
+
+extern const char * cpu_type_names[CPU_TYPES];
+extern const char * task_type_names[TASK_CLASSES];
+
+extern int                     MatchTaskClass(const vector<TaskClassSpec_t> & classes, Time_t now, TaskId_t task_id);
+extern int                     MatchTaskClass(const vector<TaskClassSpec_t> & classes, Time_t now, const TaskInfo_t & info);
+extern vector<double>          ParseBracketedValues(const string & text);
+extern unsigned                ParseName(const char * names[], unsigned count, const string & name, const string & key);
+extern vector<InputBlock_t>    ReadInputBlocks(string path);
+extern vector<TaskClassSpec_t> ReadTaskClasses(const vector<InputBlock_t> & blocks);
+
+#endif /* InputBlocks_hpp */
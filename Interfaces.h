@@ -12,9 +12,11 @@
 // Debugging (messages and exceptions)
 // Machines
 // Scheduler
+// Scheduler timers
 // Tasks
 // VM (virtual machines)
 
+#include <span>
 #include <string>
 #include <stdexcept>
 
@@ -39,9 +41,11 @@ extern void             Machine_SetState(MachineId_t machine_id, MachineState_t
 extern void             InitScheduler();                                    // Called once at the beginning
 extern void             HandleNewTask(Time_t time, TaskId_t task_id);       // Called every time a new task arrives to the system
 extern void             HandleTaskCompletion(Time_t time, TaskId_t task_id);// Called whenver a task finishes
+extern void             HandleTaskCompletionBatch(Time_t time, span<const TaskId_t> task_ids);  // All the tasks of a machine that finished at time, delivered on the next callback that is not a completion
 extern void             MemoryWarning(Time_t time, MachineId_t machine_id); // Called to alert the scheduler of memory overcommitment
 extern void             MigrationDone(Time_t time, VMId_t vm_id);           // Called to alert the scheduler that the VM has been migrated successfully
 extern void             SchedulerCheck(Time_t time);                        // Called periodically. You may want to do some monitoring and adjustments
+extern void             SchedulerTimer(Time_t time, uint64_t cookie);       // Called when a timer requested through ScheduleSchedulerTimer expires
 extern void             SimulationComplete(Time_t time);                    // Called at the end of the simulation
 extern void             SLAWarning(Time_t time, TaskId_t task_id);          // Called to alert the schedule of an SLA violation
 extern void             StateChangeComplete(Time_t time, MachineId_t machine_id);   // Called in response to an earlier request to change the state of a machine
@@ -49,6 +53,15 @@ extern void             StateChangeComplete(Time_t time, MachineId_t machine_id)
 // Statistics
 extern double           GetSLAReport(SLAType_t sla);
 
+// Scheduler Timer Interface
+// Timers are delivered on the first task arrival or periodic check at or after the requested time
+extern TimerId_t        ScheduleSchedulerTimer(Time_t time, uint64_t cookie);
+extern bool             CancelSchedulerTimer(TimerId_t timer_id);           // Returns false if the timer already fired or was cancelled
+
+// Scheduler Placement Interface
+// Adds the task like VM_AddTask and notes its VM, so its completion is batched with the others of the machine
+extern void             PlaceTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority);
+
 // Simulator Interface
 extern Time_t           Now();
 
@@ -0,0 +1,117 @@
+//
+//  Numa.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+
+#include "Internal_Interfaces.h"
+#include "Numa.hpp"
+
+void Numa::Init(unsigned nodes, double remote_slowdown, Slowdown * slowdown) {
+    if(nodes == 0)
+        ThrowException("Numa::Init(): A machine needs at least one NUMA node");
+    this->nodes = nodes;
+    this->remote_slowdown = remote_slowdown;
+    this->slowdown = slowdown;
+}
+
+vector<NumaNode_t> & Numa::Nodes(MachineId_t machine_id) {
+    auto it = machines.find(machine_id);
+    if(it != machines.end())
+        return it->second;
+    // Cores and memory are split evenly, the first nodes take the remainder
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    vector<NumaNode_t> split;
+    for(unsigned node = 0; node < nodes; node++) {
+        unsigned cores = info.num_cpus / nodes + (node < info.num_cpus % nodes ? 1 : 0);
+        unsigned memory = info.memory_size / nodes + (node < info.memory_size % nodes ? 1 : 0);
+        split.push_back(NumaNode_t{cores, memory, 0, 0, 0});
+    }
+    return machines[machine_id] = split;
+}
+
+unsigned Numa::PickNode(MachineId_t machine_id, TaskId_t task_id) {
+    // A node with a free core and room for the whole memory first, then the most free memory
+    vector<NumaNode_t> & split = Nodes(machine_id);
+    unsigned memory = GetTaskMemory(task_id);
+    unsigned best = 0;
+    for(unsigned node = 1; node < split.size(); node++) {
+        bool fits = split[node].tasks < split[node].cores && split[node].memory_used + memory <= split[node].memory;
+        bool best_fits = split[best].tasks < split[best].cores && split[best].memory_used + memory <= split[best].memory;
+        if(fits != best_fits) {
+            if(fits)
+                best = node;
+            continue;
+        }
+        if(split[node].memory - min(split[node].memory, split[node].memory_used) > split[best].memory - min(split[best].memory, split[best].memory_used))
+            best = node;
+    }
+    return best;
+}
+
+void Numa::Place(TaskId_t task_id, MachineId_t machine_id, unsigned node) {
+    // Called before the task is added, the scheduler applies the ledger once every model placed it
+    vector<NumaNode_t> & split = Nodes(machine_id);
+    if(node >= split.size())
+        ThrowException("Numa::Place(): No NUMA node ", node);
+    unsigned memory = GetTaskMemory(task_id);
+    NumaTask_t task = {machine_id, node, vector<unsigned>(split.size(), 0)};
+    unsigned left = memory;
+    unsigned local = min(left, split[node].memory - min(split[node].memory, split[node].memory_used));
+    task.memory[node] = local;
+    left -= local;
+    // The rest spills to the other nodes, the emptiest first. Memory beyond the machine stays on the home node
+    while(left) {
+        unsigned target = node;
+        unsigned room = 0;
+        for(unsigned other = 0; other < split.size(); other++) {
+            unsigned free = split[other].memory - min(split[other].memory, split[other].memory_used + task.memory[other]);
+            if(other != node && free > room) {
+                target = other;
+                room = free;
+            }
+        }
+        unsigned amount = target == node ? left : min(left, room);
+        task.memory[target] += amount;
+        left -= amount;
+    }
+    for(unsigned other = 0; other < split.size(); other++) {
+        split[other].memory_used += task.memory[other];
+        split[other].peak_memory = max(split[other].peak_memory, split[other].memory_used);
+    }
+    split[node].tasks++;
+
+    double remote = memory ? double(memory - task.memory[node]) / memory : 0;
+    if(remote > 0)
+        slowdown->Set(task_id, NUMA_SLOWDOWN, 1 + remote_slowdown * remote);
+    placed++;
+    remote_tasks += remote > 0;
+    remote_share += remote;
+    added_share += remote_slowdown * remote;
+    tasks[task_id] = task;
+}
+
+void Numa::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        auto it = tasks.find(task_id);
+        if(it == tasks.end())
+            continue;
+        vector<NumaNode_t> & split = Nodes(it->second.machine_id);
+        for(unsigned node = 0; node < split.size(); node++)
+            split[node].memory_used -= it->second.memory[node];
+        split[it->second.node].tasks--;
+        tasks.erase(it);
+    }
+}
+
+void Numa::Report() {
+    unsigned peak = 0;
+    for(auto & [machine_id, split]: machines) {
+        for(auto & node: split)
+            peak = max(peak, node.peak_memory);
+    }
+    cout << "NUMA: " << nodes << " nodes per machine, " << placed << " tasks placed, " << remote_tasks << " with remote memory (mean remote share "
+         << (placed ? 100 * remote_share / placed : 0) << "%), " << (placed ? 100 * added_share / placed : 0)
+         << "% mean run time added, peak node memory " << peak << endl;
+}
@@ -0,0 +1,61 @@
+//
+//  Numa.hpp
+//  CloudSim
+//
+//  NUMA nodes within a machine. Every machine is split evenly into nodes,
+//  each with its share of the cores and of the memory. A task is placed on
+//  a node before it is added: its memory goes to that node as far as it
+//  fits and the rest spills to the other nodes. The share of the memory
+//  that ends up remote slows the task down by the remote-access slowdown,
+//  which goes into the slowdown ledger as the NUMA factor. Memory and
+//  tasks are tracked per node so schedulers can pick the node themselves.
+//
+
+#ifndef Numa_hpp
+#define Numa_hpp
+
+#include <map>
+#include <span>
+#include <vector>
+
+#include "Interfaces.h"
+#include "Slowdown.hpp"
+
+typedef struct {
+    unsigned cores;
+    unsigned memory;
+    unsigned memory_used;
+    unsigned tasks;
+    unsigned peak_memory;
+} NumaNode_t;
+
+typedef struct {
+    MachineId_t machine_id;
+    unsigned node;
+    vector<unsigned> memory;                // Memory of the task on every node of its machine
+} NumaTask_t;
+
+class Numa {
+public:
+    Numa()                      {}
+    const NumaNode_t & GetNode(MachineId_t machine_id, unsigned node)  { return Nodes(machine_id)[node]; }
+    void     Init(unsigned nodes, double remote_slowdown, Slowdown * slowdown);
+    unsigned PickNode(MachineId_t machine_id, TaskId_t task_id);
+    void     Place(TaskId_t task_id, MachineId_t machine_id, unsigned node);
+    void     Report();
+    void     TasksCompleted(span<const TaskId_t> task_ids);
+private:
+    vector<NumaNode_t> & Nodes(MachineId_t machine_id);
+
+    unsigned nodes;
+    double remote_slowdown;                 // Extra run time of a task whose memory is all remote
+    Slowdown * slowdown;
+    map<MachineId_t, vector<NumaNode_t> > machines; // Split on first use, so machines added at runtime are covered
+    map<TaskId_t, NumaTask_t> tasks;
+    uint64_t placed = 0;
+    uint64_t remote_tasks = 0;
+    double remote_share = 0;                // Sum over the tasks placed
+    double added_share = 0;                 // Sum over the tasks placed of the extra run time
+};
+
+#endif /* Numa_hpp */
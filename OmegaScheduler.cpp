@@ -0,0 +1,216 @@
+//
+//  OmegaScheduler.cpp
+//  CloudSim
+//
+
+#include <chrono>
+
+#include "OmegaScheduler.hpp"
+
+static const unsigned max_retries = 3;
+
+static uint64_t WallClockNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void OmegaScheduler::Init(unsigned instances, unsigned tasks_per_core, const TaskTemplates * templates) {
+    this->tasks_per_core = tasks_per_core;
+    this->templates = templates;
+    pending.resize(instances);
+    stats.resize(instances, InstanceStats_t{0, 0, 0, 0, 0});
+    cell.resize(Machine_GetTotal(), CellMachine_t{X86, 0, 0, 0, 0, false});
+    RefreshCell();
+    for(unsigned i = 0; i < instances; i++)
+        workers.push_back(thread(&OmegaScheduler::Worker, this, i));
+    SimOutput("OmegaScheduler::Init(): Started " + to_string(instances) + " scheduler instances", 1);
+}
+
+void OmegaScheduler::Submit(Time_t now, const TaskInstance_t & instance, Priority_t priority) {
+    // The task waits in the queue of its instance until the next flush, with the tasks left unplaced earlier
+    PendingTask_t task = {instance.task_id, instance.template_id, priority, false};
+    pending[templates->Get(instance.template_id).sla % pending.size()].push_back(task);
+}
+
+void OmegaScheduler::Flush(Time_t now) {
+    bool empty = true;
+    for(auto & queue: pending)
+        empty = empty && queue.empty();
+    if(empty)
+        return;
+
+    RefreshCell();
+    committed.clear();
+    new_vms.clear();
+    uint64_t start = WallClockNs();
+    {
+        unique_lock<mutex> lock(work_lock);
+        busy = unsigned(workers.size());
+        generation++;
+        work_ready.notify_all();
+        work_done.wait(lock, [this] { return busy == 0; });
+    }
+    batch_ns.push_back(WallClockNs() - start);
+
+    // The simulator is single threaded, so the commits are applied here rather than by the instances
+    for(auto & placement: committed) {
+        auto it = vms.find({placement.machine_id, placement.vm_type});
+        VMId_t vm_id;
+        if(it == vms.end()) {
+            vm_id = VM_Create(placement.vm_type, placement.cpu);
+            VM_Attach(vm_id, placement.machine_id);
+            vms[{placement.machine_id, placement.vm_type}] = vm_id;
+        }
+        else {
+            vm_id = it->second;
+        }
+        PlaceTask(vm_id, placement.task_id, placement.priority);
+    }
+    SimOutput("OmegaScheduler::Flush(): Committed " + to_string(committed.size()) + " placements at " + to_string(now), 4);
+}
+
+void OmegaScheduler::RefreshCell() {
+    lock_guard<mutex> lock(cell_lock);
+    for(unsigned i = 0; i < cell.size(); i++) {
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+        CellMachine_t & machine = cell[i];
+        machine.cpu = info.cpu;
+        machine.num_cpus = info.num_cpus;
+        machine.memory_size = info.memory_size;
+        machine.memory_used = info.memory_used;
+        machine.active_tasks = info.active_tasks;
+        machine.available = info.s_state == S0;
+    }
+}
+
+void OmegaScheduler::Worker(unsigned instance) {
+    uint64_t seen = 0;
+    while(true) {
+        {
+            unique_lock<mutex> lock(work_lock);
+            work_ready.wait(lock, [&] { return stopping || generation != seen; });
+            if(stopping)
+                return;
+            seen = generation;
+        }
+        RunInstance(instance);
+        {
+            lock_guard<mutex> lock(work_lock);
+            if(--busy == 0)
+                work_done.notify_all();
+        }
+    }
+}
+
+void OmegaScheduler::RunInstance(unsigned instance) {
+    vector<CellMachine_t> snapshot;
+    {
+        lock_guard<mutex> lock(cell_lock);
+        snapshot = cell;
+    }
+    InstanceStats_t & stat = stats[instance];
+    vector<PendingTask_t> unplaced;
+    for(auto & task: pending[instance]) {
+        uint64_t start = WallClockNs();
+        bool placed = false;
+        for(unsigned attempt = 0; attempt <= max_retries && !placed; attempt++) {
+            int machine = Propose(instance, task, snapshot);
+            if(machine < 0) {
+                stat.unplaced += !task.unplaced;
+                task.unplaced = true;
+                break;
+            }
+            const TaskTemplate_t & shape = templates->Get(task.template_id);
+            Placement_t placement = {task.task_id, MachineId_t(machine), shape.vm_type, shape.cpu, task.priority};
+            placed = Commit(placement, task, snapshot);
+            if(!placed)
+                stat.conflicts++;
+        }
+        if(!placed) {
+            unplaced.push_back(task);
+            continue;
+        }
+        uint64_t latency = WallClockNs() - start;
+        stat.decisions++;
+        stat.latency_ns += latency;
+        stat.max_latency_ns = max(stat.max_latency_ns, latency);
+    }
+    // Whatever did not fit is retried on the next flush, once capacity has been released
+    pending[instance] = unplaced;
+}
+
+static bool Fits(const CellMachine_t & machine, const TaskTemplate_t & task, unsigned memory_overhead, unsigned tasks_per_core) {
+    return machine.available
+        && machine.cpu == task.cpu
+        && machine.memory_used + task.memory + memory_overhead <= machine.memory_size
+        && machine.active_tasks < machine.num_cpus * tasks_per_core;
+}
+
+int OmegaScheduler::Propose(unsigned instance, const PendingTask_t & task, const vector<CellMachine_t> & snapshot) {
+    // Each instance starts its first-fit scan at a different offset to spread the proposals
+    unsigned total = unsigned(snapshot.size());
+    unsigned offset = instance * total / unsigned(pending.size());
+    const TaskTemplate_t & shape = templates->Get(task.template_id);
+    for(unsigned i = 0; i < total; i++) {
+        unsigned machine = (offset + i) % total;
+        unsigned overhead = vms.count({machine, shape.vm_type}) ? 0 : VM_MEMORY_OVERHEAD;
+        if(Fits(snapshot[machine], shape, overhead, tasks_per_core))
+            return int(machine);
+    }
+    return -1;
+}
+
+bool OmegaScheduler::Commit(const Placement_t & placement, const PendingTask_t & task, vector<CellMachine_t> & snapshot) {
+    lock_guard<mutex> lock(cell_lock);
+    CellMachine_t & machine = cell[placement.machine_id];
+    const TaskTemplate_t & shape = templates->Get(task.template_id);
+    pair<MachineId_t, VMType_t> vm = {placement.machine_id, shape.vm_type};
+    unsigned overhead = vms.count(vm) || new_vms.count(vm) ? 0 : VM_MEMORY_OVERHEAD;
+    // A stale snapshot is only a conflict if the claim no longer fits the current state
+    if(!Fits(machine, shape, overhead, tasks_per_core)) {
+        snapshot = cell;
+        return false;
+    }
+    // The VM an earlier commit of this flush creates is only charged once
+    machine.memory_used += shape.memory + overhead;
+    new_vms.insert(vm);
+    machine.active_tasks++;
+    committed.push_back(placement);
+    snapshot[placement.machine_id] = machine;
+    return true;
+}
+
+void OmegaScheduler::Report() {
+    uint64_t decisions = 0, conflicts = 0, latency = 0, busy_ns = 0;
+    for(unsigned i = 0; i < stats.size(); i++) {
+        InstanceStats_t & stat = stats[i];
+        decisions += stat.decisions;
+        conflicts += stat.conflicts;
+        latency += stat.latency_ns;
+        cout << "Omega instance " << i << ": " << stat.decisions << " decisions, " << stat.conflicts << " conflicts, "
+             << stat.unplaced << " unplaced, mean latency " << (stat.decisions ? double(stat.latency_ns) / stat.decisions / 1000 : 0)
+             << "us, max latency " << double(stat.max_latency_ns) / 1000 << "us" << endl;
+    }
+    for(auto ns: batch_ns)
+        busy_ns += ns;
+    cout << "Omega conflict rate: " << (decisions + conflicts ? 100.0 * conflicts / (decisions + conflicts) : 0) << "%" << endl;
+    cout << "Omega mean decision latency: " << (decisions ? double(latency) / decisions / 1000 : 0) << "us" << endl;
+    cout << "Omega decision throughput: " << (busy_ns ? double(decisions) * 1e9 / busy_ns : 0) << " decisions/s over "
+         << batch_ns.size() << " batches" << endl;
+}
+
+void OmegaScheduler::Shutdown() {
+    Stop();
+    for(auto & vm: vms)
+        VM_Shutdown(vm.second);
+}
+
+void OmegaScheduler::Stop() {
+    {
+        lock_guard<mutex> lock(work_lock);
+        stopping = true;
+        work_ready.notify_all();
+    }
+    for(auto & worker: workers)
+        worker.join();
+    workers.clear();
+}
@@ -0,0 +1,100 @@
+//
+//  OmegaScheduler.hpp
+//  CloudSim
+//
+//  Optimistic shared-state scheduling: several scheduler instances propose
+//  placements in parallel from private snapshots of the cluster ("cell")
+//  state and commit them through a transactional capacity check. Every
+//  arrival is flushed before the scheduler returns from it, so no task
+//  waits for a later event to be placed. A task that found no capacity
+//  stays queued and is retried with every later flush, and the periodic
+//  check flushes to retry them once capacity has been released.
+//
+
+#ifndef OmegaScheduler_hpp
+#define OmegaScheduler_hpp
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "Interfaces.h"
+#include "TaskTemplates.hpp"
+
+typedef struct {
+    CPUType_t cpu;
+    unsigned num_cpus;
+    unsigned memory_size;
+    unsigned memory_used;                   // Memory in use, including commits not yet applied to the machine
+    unsigned active_tasks;                  // Tasks on the machine, including commits not yet applied
+    bool available;                         // Only machines in S0 accept placements
+} CellMachine_t;
+
+typedef struct {
+    TaskId_t task_id;
+    unsigned template_id;                   // Attributes of the task, shared with the other instances of its template
+    Priority_t priority;
+    bool unplaced;                          // Already counted as unplaced, it is retried on every later flush
+} PendingTask_t;
+
+typedef struct {
+    TaskId_t task_id;
+    MachineId_t machine_id;
+    VMType_t vm_type;
+    CPUType_t cpu;
+    Priority_t priority;
+} Placement_t;
+
+typedef struct {
+    uint64_t decisions;                     // Successful commits
+    uint64_t conflicts;                     // Commits rejected because the cell changed under the proposal
+    uint64_t unplaced;                      // Tasks that found no machine with enough capacity, counted once
+    uint64_t latency_ns;                    // Sum of decision latencies (snapshot to commit)
+    uint64_t max_latency_ns;
+} InstanceStats_t;
+
+class OmegaScheduler {
+public:
+    OmegaScheduler()            {}
+    ~OmegaScheduler()           { Stop(); }
+    void Init(unsigned instances, unsigned tasks_per_core, const TaskTemplates * templates);
+    void Flush(Time_t now);
+    void Report();
+    void Shutdown();
+    void Submit(Time_t now, const TaskInstance_t & instance, Priority_t priority);
+private:
+    bool Commit(const Placement_t & placement, const PendingTask_t & task, vector<CellMachine_t> & snapshot);
+    int  Propose(unsigned instance, const PendingTask_t & task, const vector<CellMachine_t> & snapshot);
+    void RefreshCell();
+    void RunInstance(unsigned instance);
+    void Stop();
+    void Worker(unsigned instance);
+
+    unsigned tasks_per_core;                // Core capacity check: tasks admitted per core
+    const TaskTemplates * templates;        // Only grows between flushes, while the instances are idle
+    vector<vector<PendingTask_t> > pending; // Per-instance queue of tasks to place
+    vector<InstanceStats_t> stats;
+    vector<uint64_t> batch_ns;              // Wall time of every flush, for throughput
+
+    // Shared cell state, guarded by cell_lock
+    mutex cell_lock;
+    vector<CellMachine_t> cell;
+    vector<Placement_t> committed;
+    set<pair<MachineId_t, VMType_t> > new_vms;     // VMs the commits of this flush will create
+
+    // Worker threads, one per scheduler instance
+    vector<thread> workers;
+    mutex work_lock;
+    condition_variable work_ready;
+    condition_variable work_done;
+    uint64_t generation = 0;
+    unsigned busy = 0;
+    bool stopping = false;
+
+    map<pair<MachineId_t, VMType_t>, VMId_t> vms;  // One VM per machine and VM type, created on first placement
+};
+
+#endif /* OmegaScheduler_hpp */
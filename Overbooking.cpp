@@ -0,0 +1,240 @@
+//
+//  Overbooking.cpp
+//  CloudSim
+//
+
+#include <cmath>
+
+#include "Overbooking.hpp"
+
+#define USAGE_MIN_SAMPLES   10              // Samples a class needs before its tasks count below their declared memory
+#define MARGIN_WIDEN        1.5
+#define MARGIN_DECAY        0.98
+#define MARGIN_MAX          8
+#define DECLARED_DECREASE   0.95
+#define DECLARED_INCREASE   0.002
+#define CPU_LIMIT_DECREASE  0.9
+#define CPU_LIMIT_INCREASE  0.01
+
+static double NormalQuantile(double probability) {
+    // Bisection on the upper tail, the quantile is only computed once
+    double low = 0, high = 10;
+    for(unsigned i = 0; i < 60; i++) {
+        double mid = (low + high) / 2;
+        if(0.5 * erfc(mid / sqrt(2.0)) > probability)
+            low = mid;
+        else
+            high = mid;
+    }
+    return (low + high) / 2;
+}
+
+void Overbooking::Init(string path, double target, double declared_limit, double cpu_limit) {
+    if(target <= 0 || target >= 0.5)
+        ThrowException("Overbooking::Init(): The target overflow probability must be in (0, 0.5)");
+    if(declared_limit < 1)
+        ThrowException("Overbooking::Init(): The declared memory limit cannot be below the memory of the machine");
+    this->declared_limit = initial_declared_limit = declared_limit;
+    if(cpu_limit < 1)
+        ThrowException("Overbooking::Init(): At least one task per core must be admitted");
+    z = NormalQuantile(target);
+    vector<InputBlock_t> blocks = ReadInputBlocks(path);
+    classes = ReadTaskClasses(blocks);
+    usage_classes.assign(classes.size() + 1, UsageClass_t{1, 0, 0, 0, 0});
+    for(auto & block: blocks) {
+        if(block.type != "usage model")
+            continue;
+        unsigned usage_class = unsigned(stoul(block.fields["Task class"]));
+        if(usage_class >= classes.size())
+            ThrowException("Overbooking::Init(): No task class ", usage_class);
+        UsageClass_t & model = usage_classes[usage_class];
+        model.usage = stod(block.fields["Usage"]);
+        model.spread = block.fields.count("Spread") ? stod(block.fields["Spread"]) : 0;
+        if(model.usage <= 0 || model.usage > 1)
+            ThrowException("Overbooking::Init(): Usage is a share of the declared memory in (0, 1], task class ", usage_class);
+    }
+    for(unsigned i = 0; i < Machine_GetTotal(); i++) {
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+        machines.push_back(OverbookMachine_t{info.memory_size, 0, 0, 0, 0, info.num_cpus, cpu_limit, false, {}});
+    }
+}
+
+void Overbooking::Predict(unsigned usage_class, unsigned memory, double & mean, double & variance) {
+    UsageClass_t & model = usage_classes[usage_class];
+    if(model.samples < USAGE_MIN_SAMPLES) {
+        mean = memory;
+        variance = 0;
+        return;
+    }
+    mean = model.mean * memory;
+    variance = model.m2 / double(model.samples - 1) * memory * memory;
+}
+
+bool Overbooking::Admits(MachineId_t machine_id, TaskId_t task_id, double mean, double variance) {
+    OverbookMachine_t & machine = machines[machine_id];
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    if(info.cpu != RequiredCPUType(task_id) || info.s_state != S0)
+        return false;
+    if(machine.tasks + 1 > machine.cpu_limit * machine.num_cpus)
+        return false;
+    unsigned declared = GetTaskMemory(task_id);
+    if(machine.vms.find(RequiredVMType(task_id)) == machine.vms.end()) {
+        mean += VM_MEMORY_OVERHEAD;
+        declared += VM_MEMORY_OVERHEAD;
+    }
+    if(info.memory_used + declared > declared_limit * machine.capacity)
+        return false;
+    return machine.mean + mean + margin * z * sqrt(machine.variance + variance) <= machine.capacity;
+}
+
+bool Overbooking::Place(TaskId_t task_id, Priority_t priority) {
+    unsigned usage_class = arriving[task_id];
+    unsigned memory = GetTaskMemory(task_id);
+    double mean, variance;
+    Predict(usage_class, memory, mean, variance);
+    // Best fit on the predicted use packs the machines densely
+    int best = -1;
+    for(unsigned i = 0; i < machines.size(); i++) {
+        if(Admits(MachineId_t(i), task_id, mean, variance) && (best < 0 || machines[i].mean > machines[best].mean))
+            best = int(i);
+    }
+    if(best < 0 && running.empty()) {
+        // A task that fits no machine would wait forever, so once the cluster drains it goes to the least used one
+        for(unsigned i = 0; i < machines.size(); i++) {
+            if(Machine_GetCPUType(MachineId_t(i)) == RequiredCPUType(task_id) && (best < 0 || machines[i].mean < machines[best].mean))
+                best = int(i);
+        }
+    }
+    if(best < 0)
+        return false;
+    MachineId_t machine_id = MachineId_t(best);
+    OverbookMachine_t & machine = machines[machine_id];
+    VMType_t vm_type = RequiredVMType(task_id);
+    if(machine.vms.find(vm_type) == machine.vms.end()) {
+        VMId_t vm_id = VM_Create(vm_type, Machine_GetCPUType(machine_id));
+        VM_Attach(vm_id, machine_id);
+        machine.vms[vm_type] = vm_id;
+        machine.mean += VM_MEMORY_OVERHEAD;
+        machine.actual += VM_MEMORY_OVERHEAD;
+    }
+    UsageClass_t & model = usage_classes[usage_class];
+    normal_distribution<double> draw(model.usage, model.spread);
+    double actual = memory * min(1.0, max(0.01, model.spread > 0 ? draw(generator) : model.usage));
+    machine.mean += mean;
+    machine.variance += variance;
+    machine.actual += actual;
+    machine.tasks++;
+    running[task_id] = OverbookTask_t{machine_id, usage_class, actual, mean, variance};
+    arriving.erase(task_id);
+    PlaceTask(machine.vms[vm_type], task_id, priority);
+    return true;
+}
+
+void Overbooking::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    int spec = MatchTaskClass(classes, now, task_id);
+    arriving[task_id] = spec < 0 ? unsigned(classes.size()) : unsigned(spec);
+    if(queue.empty() && Place(task_id, priority))
+        return;
+    queue.push_back(OverbookRequest_t{task_id, priority});
+    queued++;
+}
+
+void Overbooking::MemoryWarning(MachineId_t machine_id) {
+    // Called from inside the placement that overflowed, so only the limit changes here
+    warnings++;
+    if(machine_id < machines.size()) {
+        declared_limit = max(1.0, declared_limit * DECLARED_DECREASE);
+        warned = true;
+    }
+}
+
+void Overbooking::PeriodicCheck(Time_t now) {
+    bool overflow = false;
+    double declared = 0, capacity = 0;
+    for(unsigned i = 0; i < machines.size(); i++) {
+        OverbookMachine_t & machine = machines[i];
+        if(!machine.tasks)
+            continue;
+        machine_checks++;
+        bool overflowing = machine.actual > machine.capacity;
+        overflow_checks += overflowing;
+        // Only the start of an overflow widens the margin, not every check it lasts
+        overflow |= overflowing && !machine.overflowing;
+        machine.overflowing = overflowing;
+        declared += Machine_GetInfo(MachineId_t(i)).memory_used;
+        capacity += machine.capacity;
+    }
+    if(overflow)
+        margin = min(double(MARGIN_MAX), margin * MARGIN_WIDEN);
+    else
+        margin = max(1.0, margin * MARGIN_DECAY);
+    if(!warned)
+        declared_limit = min(initial_declared_limit, declared_limit + DECLARED_INCREASE);
+    warned = false;
+    if(capacity) {
+        density_sum += declared / capacity;
+        peak_density = max(peak_density, declared / capacity);
+        density_checks++;
+    }
+    SimOutput("Overbooking::PeriodicCheck(): Margin " + to_string(margin) + " at time " + to_string(now), 2);
+}
+
+void Overbooking::TasksCompleted(Time_t now, span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        auto it = running.find(task_id);
+        if(it == running.end())
+            continue;
+        OverbookTask_t & task = it->second;
+        OverbookMachine_t & machine = machines[task.machine_id];
+        unsigned memory = GetTaskMemory(task_id);
+        machine.mean -= task.mean;
+        machine.variance = max(0.0, machine.variance - task.variance);
+        machine.actual -= task.actual;
+        machine.tasks--;
+        // Welford's update with the share of the declared memory the task used. A task that declares none has no share
+        if(memory) {
+            UsageClass_t & model = usage_classes[task.usage_class];
+            double share = task.actual / memory;
+            double delta = share - model.mean;
+            model.samples++;
+            model.mean += delta / double(model.samples);
+            model.m2 += delta * (share - model.mean);
+        }
+        completed++;
+        if(IsSLAViolation(task_id)) {
+            violations++;
+            machine.cpu_limit = max(1.0, machine.cpu_limit * CPU_LIMIT_DECREASE);
+        }
+        else {
+            machine.cpu_limit += CPU_LIMIT_INCREASE;
+        }
+        running.erase(it);
+    }
+    while(!queue.empty() && Place(queue.front().task_id, queue.front().priority))
+        queue.pop_front();
+}
+
+void Overbooking::Report() {
+    double cpu_limit = 0;
+    for(auto & machine: machines)
+        cpu_limit += machine.cpu_limit;
+    cout << "Overbooking: declared memory " << 100 * (density_checks ? density_sum / density_checks : 0) << "% of the machines in use on average, peak "
+         << 100 * peak_density << "%, " << warnings << " memory warnings" << endl;
+    cout << "Overbooking: overflow of the synthetic usage model in " << overflow_checks << " of " << machine_checks << " machine checks, final margin " << margin << ", final declared limit "
+         << 100 * declared_limit << "% of the memory, "
+         << queued << " tasks queued, " << violations << " of " << completed << " SLA violations, mean " << (machines.empty() ? 0 : cpu_limit / machines.size())
+         << " tasks per core admitted" << endl;
+    for(unsigned i = 0; i < usage_classes.size(); i++) {
+        UsageClass_t & model = usage_classes[i];
+        if(model.samples)
+            SimOutput("Overbooking::Report(): Task class " + to_string(i) + " uses " + to_string(model.mean) + " of its declared memory over "
+                      + to_string(model.samples) + " samples of the synthetic usage model", 1);
+    }
+}
+
+void Overbooking::Shutdown() {
+    for(auto & machine: machines) {
+        for(auto & [vm_type, vm_id]: machine.vms)
+            VM_Shutdown(vm_id);
+    }
+}
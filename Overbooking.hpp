@@ -0,0 +1,109 @@
+//
+//  Overbooking.hpp
+//  CloudSim
+//
+//  Statistical overbooking of memory and cores. Every task class has a
+//  model of its actual memory use as a share of the memory it declares.
+//  The simulator has no notion of actual use, it charges every task its
+//  declared memory, so the actual use is synthetic: every task draws it
+//  from the model of its class, and the controller learns the model back
+//  from those draws when tasks complete, keeping an online mean and
+//  variance per class. What it shows is how the admission behaves while
+//  the estimate converges, not what real workloads use. A placement is
+//  admitted while the predicted use of the machine stays under its memory
+//  with the target overflow probability, the sum of the task uses being
+//  taken as normal. Until a class has enough samples its tasks count at
+//  their declared memory. The declared memory the simulator reports for a
+//  machine is observed directly, and when it exceeds the memory the
+//  simulator slows the machine down and raises MemoryWarning. That
+//  declared memory is therefore capped as well, above the memory at
+//  first, and every warning lowers the cap. A check that finds the
+//  modeled use over the memory widens the safety margin instead. Both
+//  relax again while no overflow is seen. Cores are overbooked in tasks
+//  per core, lowered by every SLA violation of a completed task and
+//  raised slowly by the tasks that meet their SLA.
+//
+
+#ifndef Overbooking_hpp
+#define Overbooking_hpp
+
+#include <deque>
+#include <map>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "InputBlocks.hpp"
+
+typedef struct {
+    double usage;                           // Mean actual use over the declared memory, drives the draws
+    double spread;                          // Standard deviation of that share
+    uint64_t samples;                       // Online estimate from the completed tasks
+    double mean;
+    double m2;
+} UsageClass_t;
+
+typedef struct {
+    unsigned capacity;
+    double mean;                            // Predicted use of the placed tasks and the VMs
+    double variance;
+    double actual;                          // Modeled actual use
+    unsigned tasks;
+    unsigned num_cpus;
+    double cpu_limit;                       // Tasks admitted per core
+    bool overflowing;
+    map<VMType_t, VMId_t> vms;
+} OverbookMachine_t;
+
+typedef struct {
+    MachineId_t machine_id;
+    unsigned usage_class;
+    double actual;
+    double mean;
+    double variance;
+} OverbookTask_t;
+
+typedef struct {
+    TaskId_t task_id;
+    Priority_t priority;
+} OverbookRequest_t;
+
+class Overbooking {
+public:
+    Overbooking()               {}
+    void Init(string path, double target, double declared_limit, double cpu_limit);
+    void MemoryWarning(MachineId_t machine_id);
+    void NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void PeriodicCheck(Time_t now);
+    void Report();
+    void Shutdown();
+    void TasksCompleted(Time_t now, span<const TaskId_t> task_ids);
+private:
+    bool Admits(MachineId_t machine_id, TaskId_t task_id, double mean, double variance);
+    bool Place(TaskId_t task_id, Priority_t priority);
+    void Predict(unsigned usage_class, unsigned memory, double & mean, double & variance);
+
+    vector<TaskClassSpec_t> classes;
+    vector<UsageClass_t> usage_classes;     // One per task class, the last for tasks that match none
+    vector<OverbookMachine_t> machines;
+    map<TaskId_t, OverbookTask_t> running;
+    map<TaskId_t, unsigned> arriving;       // Class of the tasks waiting in the queue
+    deque<OverbookRequest_t> queue;
+    mt19937_64 generator;
+    double z;                               // Normal quantile of the target overflow probability
+    double margin = 1;                      // Multiplies z, widened by modeled overflows
+    double declared_limit;                  // Declared memory a machine may hold over its memory, lowered by warnings
+    double initial_declared_limit;
+    bool warned = false;                    // A warning arrived since the last check
+    uint64_t warnings = 0;
+    uint64_t overflow_checks = 0;
+    uint64_t machine_checks = 0;
+    uint64_t queued = 0;
+    uint64_t violations = 0;
+    uint64_t completed = 0;
+    double density_sum = 0;                 // Declared over nominal memory of the machines in use, summed over the checks
+    double peak_density = 0;
+    uint64_t density_checks = 0;
+};
+
+#endif /* Overbooking_hpp */
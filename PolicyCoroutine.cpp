@@ -0,0 +1,73 @@
+//
+//  PolicyCoroutine.cpp
+//  CloudSim
+//
+
+#include <map>
+
+#include "PolicyCoroutine.hpp"
+
+typedef struct {
+    coroutine_handle<> handle;
+    Time_t * time;
+} Waiter_t;
+
+alignas(max_align_t) static char frames[COROUTINE_FRAMES][COROUTINE_FRAME_SIZE];
+static vector<unsigned> free_frames;
+static bool frames_initialized = false;
+static map<pair<PolicyEvent_t, uint64_t>, vector<Waiter_t> > waiters;
+static uint64_t next_timer_cookie = 0;
+
+void * Coroutine_AllocateFrame(size_t size) {
+    if(!frames_initialized) {
+        for(unsigned i = COROUTINE_FRAMES; i > 0; i--)
+            free_frames.push_back(i - 1);
+        frames_initialized = true;
+    }
+    if(size > COROUTINE_FRAME_SIZE)
+        ThrowException("Coroutine_AllocateFrame(): Coroutine frame is larger than the pool block size ", unsigned(size));
+    if(free_frames.empty())
+        ThrowException("Coroutine_AllocateFrame(): Out of coroutine frames, too many coroutines alive");
+    unsigned frame = free_frames.back();
+    free_frames.pop_back();
+    return frames[frame];
+}
+
+void Coroutine_FreeFrame(void * frame) {
+    free_frames.push_back(unsigned((static_cast<char *>(frame) - frames[0]) / COROUTINE_FRAME_SIZE));
+}
+
+unsigned Coroutine_GetActive() {
+    return frames_initialized ? COROUTINE_FRAMES - unsigned(free_frames.size()) : 0;
+}
+
+void Coroutine_Wait(PolicyEvent_t event, uint64_t id, coroutine_handle<> handle, Time_t * time) {
+    if(event == TIMER_EVENT) {
+        // Timer waits are keyed by their cookie, the time itself goes to the scheduler timers
+        uint64_t cookie = COROUTINE_TIMER_FLAG | next_timer_cookie++;
+        ScheduleSchedulerTimer(id, cookie);
+        id = cookie;
+    }
+    waiters[{event, id}].push_back(Waiter_t{handle, time});
+}
+
+void Coroutine_Resume(PolicyEvent_t event, uint64_t id, Time_t time) {
+    auto it = waiters.find({event, id});
+    if(it == waiters.end())
+        return;
+    // A resumed coroutine may wait on the same event again, so detach the list first
+    vector<Waiter_t> ready;
+    ready.swap(it->second);
+    waiters.erase(it);
+    for(auto & waiter: ready) {
+        *waiter.time = time;
+        waiter.handle.resume();
+    }
+}
+
+bool Coroutine_TimerExpired(Time_t time, uint64_t cookie) {
+    if(!(cookie & COROUTINE_TIMER_FLAG))
+        return false;
+    Coroutine_Resume(TIMER_EVENT, cookie, time);
+    return true;
+}
@@ -0,0 +1,70 @@
+//
+//  PolicyCoroutine.hpp
+//  CloudSim
+//
+//  Coroutine layer on top of the scheduler callbacks. A policy written as a
+//  PolicyTask coroutine can co_await StateChange(machine), Migration(vm),
+//  TaskDone(task) or Timer(time) instead of keeping a hand-rolled state
+//  machine across callbacks. Every awaitable resumes with the event time.
+//
+//  Coroutines are started eagerly and destroy themselves when they finish.
+//  Their frames come from a fixed pool, so starting one does not allocate.
+//
+
+#ifndef PolicyCoroutine_hpp
+#define PolicyCoroutine_hpp
+
+#include <coroutine>
+
+#include "Interfaces.h"
+
+#define COROUTINE_FRAME_SIZE    1024        // Largest coroutine frame the pool can hold
+#define COROUTINE_FRAMES        256         // Number of coroutines that can be alive at once
+#define COROUTINE_TIMER_FLAG    (uint64_t(1) << 63) // Marks the timer cookies owned by the dispatcher
+
+typedef enum {
+    STATE_CHANGE_EVENT,
+    MIGRATION_EVENT,
+    TASK_DONE_EVENT,
+    TIMER_EVENT
+} PolicyEvent_t;
+
+// Coroutine interface
+extern void *   Coroutine_AllocateFrame(size_t size);
+extern void     Coroutine_FreeFrame(void * frame);
+extern unsigned Coroutine_GetActive();
+extern void     Coroutine_Resume(PolicyEvent_t event, uint64_t id, Time_t time);   // Called from the scheduler callbacks
+extern bool     Coroutine_TimerExpired(Time_t time, uint64_t cookie);               // Returns false if the timer is not a coroutine timer
+extern void     Coroutine_Wait(PolicyEvent_t event, uint64_t id, coroutine_handle<> handle, Time_t * time);
+
+class PolicyTask {
+public:
+    struct promise_type {
+        PolicyTask get_return_object()          { return PolicyTask(); }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_never final_suspend() noexcept  { return {}; }
+        void return_void()                      {}
+        void unhandled_exception()              { throw; }
+        static void * operator new(size_t size) { return Coroutine_AllocateFrame(size); }
+        static void operator delete(void * frame) { Coroutine_FreeFrame(frame); }
+    };
+};
+
+class EventAwaiter {
+public:
+    EventAwaiter(PolicyEvent_t event, uint64_t id) : event(event), id(id), time(0) {}
+    bool await_ready()                          { return event == TIMER_EVENT && id <= Now(); }
+    void await_suspend(coroutine_handle<> handle) { Coroutine_Wait(event, id, handle, &time); }
+    Time_t await_resume()                       { return event == TIMER_EVENT && time == 0 ? Now() : time; }
+private:
+    PolicyEvent_t event;
+    uint64_t id;
+    Time_t time;
+};
+
+inline EventAwaiter StateChange(MachineId_t machine_id) { return EventAwaiter(STATE_CHANGE_EVENT, machine_id); }
+inline EventAwaiter Migration(VMId_t vm_id)             { return EventAwaiter(MIGRATION_EVENT, vm_id); }
+inline EventAwaiter TaskDone(TaskId_t task_id)          { return EventAwaiter(TASK_DONE_EVENT, task_id); }
+inline EventAwaiter Timer(Time_t time)                  { return EventAwaiter(TIMER_EVENT, time); }
+
+#endif /* PolicyCoroutine_hpp */
@@ -0,0 +1,196 @@
+//
+//  RareEvent.cpp
+//  CloudSim
+//
+
+#include <cmath>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "RareEvent.hpp"
+
+static const double t_quantile[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228};  // 97.5%, 1 to 10 degrees of freedom
+
+void RareEvent::Init(unsigned replications, unsigned split, const vector<double> & levels) {
+    this->split = split;
+    this->levels = levels;
+    record = SplitRecord_t{0, 0, false, 0, 0};
+    for(unsigned i = 0; i < Machine_GetTotal(); i++)
+        candidates[Machine_GetCPUType(MachineId_t(i))].push_back(MachineId_t(i));
+
+    char path[] = "/tmp/CloudSimSplitXXXXXX";
+    results = mkstemp(path);
+    if(results < 0)
+        ThrowException("RareEvent::Init(): Cannot create the results file ", string(path));
+    unlink(path);
+    fcntl(results, F_SETFL, O_APPEND);
+
+    for(unsigned i = 1; i < replications; i++) {
+        if(Clone()) {
+            record.replication = i;
+            break;
+        }
+    }
+    random.seed(record.replication);
+}
+
+bool RareEvent::Clone() {
+    cout.flush();
+    pid_t pid = fork();
+    if(pid < 0)
+        ThrowException("RareEvent::Clone(): Cannot fork a copy of the simulation");
+    if(pid > 0) {
+        clones.push_back(pid);
+        return false;
+    }
+    // Copies run silently and only report through the results file
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    master = false;
+    clones.clear();
+    record.violations = record.completions = 0;
+    return true;
+}
+
+double RareEvent::Stress(Time_t now) {
+    // Projected completion time of every running SLA0 task over the time left to its target, under a fair core share
+    double stress = 0;
+    for(auto it = sla0_tasks.begin(); it != sla0_tasks.end(); ) {
+        TaskInfo_t task = GetTaskInfo(it->first);
+        if(task.completed || task.target_completion <= now) {
+            // Already decided, either way
+            it = sla0_tasks.erase(it);
+            continue;
+        }
+        MachineInfo_t info = Machine_GetInfo(it->second);
+        double share = min(1.0, double(info.num_cpus) / max(info.active_tasks, 1u));
+        double projected = double(task.remaining_instructions) / (info.performance[info.p_state] * share);
+        stress = max(stress, projected / double(task.target_completion - now));
+        it++;
+    }
+    return stress;
+}
+
+void RareEvent::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    CPUType_t cpu = RequiredCPUType(task_id);
+    auto it = candidates.find(cpu);
+    if(it == candidates.end())
+        ThrowException("RareEvent::NewTask(): No machine for the CPU type of task ", task_id);
+
+    // Power of two choices: the less loaded of two machines drawn at random
+    MachineId_t machine_id = it->second[random() % it->second.size()];
+    MachineId_t other = it->second[random() % it->second.size()];
+    MachineInfo_t first = Machine_GetInfo(machine_id), second = Machine_GetInfo(other);
+    if(second.active_tasks * first.num_cpus < first.active_tasks * second.num_cpus)
+        machine_id = other;
+
+    VMType_t vm_type = RequiredVMType(task_id);
+    auto vm = vms.find({machine_id, vm_type});
+    VMId_t vm_id;
+    if(vm == vms.end()) {
+        vm_id = VM_Create(vm_type, cpu);
+        VM_Attach(vm_id, machine_id);
+        vms[{machine_id, vm_type}] = vm_id;
+    }
+    else {
+        vm_id = vm->second;
+    }
+    PlaceTask(vm_id, task_id, priority);
+    if(RequiredSLA(task_id) == SLA0)
+        sla0_tasks[task_id] = machine_id;
+    SimOutput("RareEvent::NewTask(): Task " + to_string(task_id) + " placed on machine " + to_string(machine_id) + " at " + to_string(now), 4);
+}
+
+void RareEvent::PeriodicCheck(Time_t now) {
+    double stress = Stress(now);
+    while(level > 0 && stress < levels[level - 1]) {
+        if(born == level) {
+            SimOutput("RareEvent::PeriodicCheck(): Truncated below level " + to_string(level) + " at " + to_string(now), 2);
+            record.truncated = true;
+            Finish();
+        }
+        // The copies made at this level are truncated as well, so their weight comes back
+        level--;
+        weight *= split;
+    }
+    while(level < levels.size() && stress >= levels[level]) {
+        level++;
+        record.level = max(record.level, level);
+        weight /= split;
+        // Every copy continues the run from here with its own placement decisions
+        for(unsigned copy = 1; copy < split; copy++) {
+            if(Clone()) {
+                born = level;
+                random.seed(random() + copy);
+                break;
+            }
+        }
+        SimOutput("RareEvent::PeriodicCheck(): Crossed level " + to_string(level) + " at " + to_string(now), 2);
+    }
+}
+
+void RareEvent::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        if(RequiredSLA(task_id) != SLA0)
+            continue;
+        record.completions += weight;
+        if(IsSLAViolation(task_id))
+            record.violations += weight;
+    }
+}
+
+void RareEvent::WaitForClones() {
+    for(auto pid: clones)
+        waitpid(pid, nullptr, 0);
+    clones.clear();
+}
+
+void RareEvent::Finish() {
+    // Copies finish only after their own copies, so the master is the last to finish
+    WaitForClones();
+    if(write(results, &record, sizeof(record)) != sizeof(record))
+        ThrowException("RareEvent::Finish(): Cannot write the results of replication ", record.replication);
+    if(!master)
+        _exit(0);
+}
+
+void RareEvent::Report() {
+    Finish();
+
+    map<unsigned, pair<double, double> > replications;
+    unsigned runs = 0, crossed = 0, truncated = 0;
+    SplitRecord_t result;
+    for(off_t offset = 0; pread(results, &result, sizeof(result), offset) == sizeof(result); offset += sizeof(result)) {
+        replications[result.replication].first += result.violations;
+        replications[result.replication].second += result.completions;
+        crossed = max(crossed, result.level);
+        truncated += result.truncated;
+        runs++;
+    }
+    close(results);
+
+    vector<double> estimates;
+    for(auto & [replication, counts]: replications) {
+        if(counts.second > 0)
+            estimates.push_back(counts.first / counts.second);
+        SimOutput("RareEvent::Report(): Replication " + to_string(replication) + " weighted SLA0 violations " + to_string(counts.first) + " of " + to_string(counts.second), 1);
+    }
+    cout << "Rare event splitting: " << runs << " runs over " << replications.size() << " replications, " << truncated << " truncated, "
+         << crossed << " of " << levels.size() << " stress levels reached" << endl;
+    if(estimates.empty()) {
+        cout << "Rare event splitting: no SLA0 task completed" << endl;
+        return;
+    }
+    double mean = 0, variance = 0;
+    for(auto estimate: estimates)
+        mean += estimate / estimates.size();
+    for(auto estimate: estimates)
+        variance += estimates.size() > 1 ? (estimate - mean) * (estimate - mean) / (estimates.size() - 1) : 0;
+    unsigned freedom = unsigned(estimates.size()) - 1;
+    cout << "Rare event splitting SLA0 violation probability: " << mean;
+    if(freedom)
+        cout << " +/- " << (freedom <= 10 ? t_quantile[freedom - 1] : 1.96) * sqrt(variance / estimates.size()) << " (95%)";
+    cout << endl;
+}
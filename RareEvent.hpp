@@ -0,0 +1,68 @@
+//
+//  RareEvent.hpp
+//  CloudSim
+//
+//  Multilevel splitting estimate of the SLA0 violation probability. The
+//  importance function, read on every periodic check, is the worst ratio of
+//  projected completion time to time left before the target among the
+//  running SLA0 tasks. Every time a run climbs past a stress level it is
+//  cloned into several copies, one fork of the simulator per copy. Each
+//  copy carries an equal share of the run's weight, and the weighted
+//  violation and completion counts of all the copies estimate the
+//  probability of the original run. Following RESTART, a copy that falls
+//  back below the level it was made at is truncated, and the run it was
+//  copied from, which carries on, takes its weight back.
+//  Clones only differ through the placement policy, a randomized
+//  power-of-two-choices that is reseeded in every clone, so the policy
+//  under test is the randomized one. Independent replications, forked at
+//  start with distinct seeds, give the confidence interval.
+//
+
+#ifndef RareEvent_hpp
+#define RareEvent_hpp
+
+#include <map>
+#include <random>
+#include <vector>
+#include <sys/types.h>
+
+#include "Interfaces.h"
+
+typedef struct {
+    unsigned replication;
+    unsigned level;                         // Highest level the run reached
+    bool truncated;                         // Ended by falling below the level it was copied at
+    double violations;                      // Weighted SLA0 violations and completions
+    double completions;
+} SplitRecord_t;
+
+class RareEvent {
+public:
+    RareEvent()                 {}
+    void Init(unsigned replications, unsigned split, const vector<double> & levels);
+    void NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void PeriodicCheck(Time_t now);
+    void Report();
+    void TasksCompleted(span<const TaskId_t> task_ids);
+private:
+    bool   Clone();
+    double Stress(Time_t now);
+    void   Finish();
+    void   WaitForClones();
+
+    unsigned split;                         // Copies made at every level crossing
+    vector<double> levels;                  // Stress levels, increasing
+    int results;                            // File shared by every clone, records are appended on exit
+    bool master = true;                     // Only the original process reports
+    SplitRecord_t record;
+    unsigned level = 0;                     // Levels the run is above at the moment
+    unsigned born = 0;                      // Level the run was copied at, 0 for the runs that are never truncated
+    double weight = 1;
+    mt19937_64 random;
+    vector<pid_t> clones;                   // Children forked by this process
+    map<CPUType_t, vector<MachineId_t> > candidates;
+    map<TaskId_t, MachineId_t> sla0_tasks;  // Running SLA0 tasks and their machines
+    map<pair<MachineId_t, VMType_t>, VMId_t> vms;  // One VM per machine and VM type, created on first placement
+};
+
+#endif /* RareEvent_hpp */
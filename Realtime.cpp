@@ -0,0 +1,177 @@
+//
+//  Realtime.cpp
+//  CloudSim
+//
+
+#include "Realtime.hpp"
+
+void Realtime::Init(unsigned reserve_cores) {
+    if(reserve_cores == 0)
+        ThrowException("Realtime::Init(): A reservation needs at least one core");
+    this->reserve_cores = reserve_cores;
+    machines.assign(Machine_GetTotal(), RtMachine_t{0, false, 0, 0, 0, {}});
+}
+
+unsigned Realtime::Reservable(MachineId_t machine_id) {
+    // Only cores that no task is using can be reserved, so a reservation never pushes the machine past its cores
+    RtMachine_t & machine = machines[machine_id];
+    unsigned num_cpus = Machine_GetInfo(machine_id).num_cpus;
+    return num_cpus - min(num_cpus, machine.reserved + machine.be_running);
+}
+
+bool Realtime::Reserve(MachineId_t machine_id, unsigned cores) {
+    if(machine_id >= machines.size() || Reservable(machine_id) < cores)
+        return false;
+    RtMachine_t & machine = machines[machine_id];
+    if(!machine.has_rt_vm) {
+        machine.rt_vm = VM_Create(LINUX_RT, Machine_GetCPUType(machine_id));
+        VM_Attach(machine.rt_vm, machine_id);
+        machine.has_rt_vm = true;
+    }
+    machine.reserved += cores;
+    unsigned reserved = 0;
+    for(auto & other: machines)
+        reserved += other.reserved;
+    peak_reserved = max(peak_reserved, reserved);
+    SimOutput("Realtime::Reserve(): Machine " + to_string(machine_id) + " reserves " + to_string(machine.reserved) + " cores", 2);
+    return true;
+}
+
+void Realtime::Release(MachineId_t machine_id) {
+    // Idle reserved cores go back in the steps they were reserved in
+    RtMachine_t & machine = machines[machine_id];
+    unsigned released = 0;
+    while(machine.reserved >= machine.rt_running + reserve_cores) {
+        machine.reserved -= reserve_cores;
+        released += reserve_cores;
+    }
+    if(released)
+        SimOutput("Realtime::Release(): Machine " + to_string(machine_id) + " keeps " + to_string(machine.reserved) + " cores reserved", 2);
+}
+
+bool Realtime::PlaceRealtime(TaskId_t task_id) {
+    CPUType_t cpu = RequiredCPUType(task_id);
+    int best = -1;
+    for(unsigned i = 0; i < machines.size(); i++) {
+        RtMachine_t & machine = machines[i];
+        if(machine.reserved > machine.rt_running && Machine_GetCPUType(MachineId_t(i)) == cpu
+           && (best < 0 || machine.rt_running < machines[best].rt_running))
+            best = int(i);
+    }
+    if(best < 0) {
+        // Grow the reservation where the most cores are free
+        unsigned most = 0;
+        for(unsigned i = 0; i < machines.size(); i++) {
+            MachineId_t machine_id = MachineId_t(i);
+            if(Machine_GetCPUType(machine_id) != cpu || Machine_GetInfo(machine_id).s_state != S0)
+                continue;
+            unsigned reservable = Reservable(machine_id);
+            if(reservable >= reserve_cores && reservable > most) {
+                best = int(i);
+                most = reservable;
+            }
+        }
+        if(best < 0 || !Reserve(MachineId_t(best), reserve_cores))
+            return false;
+    }
+    RtMachine_t & machine = machines[best];
+    PlaceTask(machine.rt_vm, task_id, HIGH_PRIORITY);
+    machine.rt_running++;
+    running[task_id] = {MachineId_t(best), true};
+    return true;
+}
+
+bool Realtime::PlaceBestEffort(TaskId_t task_id, Priority_t priority) {
+    // Only up to the unreserved cores, so a machine without a reservation keeps room for one
+    CPUType_t cpu = RequiredCPUType(task_id);
+    int best = -1;
+    double best_load = 0;
+    for(unsigned i = 0; i < machines.size(); i++) {
+        MachineId_t machine_id = MachineId_t(i);
+        RtMachine_t & machine = machines[i];
+        MachineInfo_t info = Machine_GetInfo(machine_id);
+        if(info.cpu != cpu || info.s_state != S0)
+            continue;
+        if(machine.be_running + machine.reserved >= info.num_cpus)
+            continue;
+        double load = double(machine.be_running) / (info.num_cpus - machine.reserved);
+        if(best < 0 || load < best_load) {
+            best = int(i);
+            best_load = load;
+        }
+    }
+    if(best < 0)
+        return false;
+    RtMachine_t & machine = machines[best];
+    VMType_t vm_type = RequiredVMType(task_id);
+    if(machine.be_vms.find(vm_type) == machine.be_vms.end()) {
+        VMId_t vm_id = VM_Create(vm_type, cpu);
+        VM_Attach(vm_id, MachineId_t(best));
+        machine.be_vms[vm_type] = vm_id;
+    }
+    PlaceTask(machine.be_vms[vm_type], task_id, priority);
+    machine.be_running++;
+    running[task_id] = {MachineId_t(best), false};
+    return true;
+}
+
+bool Realtime::Dispatch(Time_t now, const RtRequest_t & request) {
+    bool realtime = RequiredVMType(request.task_id) == LINUX_RT;
+    if(!(realtime ? PlaceRealtime(request.task_id) : PlaceBestEffort(request.task_id, request.priority)))
+        return false;
+    (realtime ? rt_wait : be_wait) += double(now - request.arrival);
+    return true;
+}
+
+void Realtime::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    RtRequest_t request = {task_id, priority, now};
+    bool realtime = RequiredVMType(task_id) == LINUX_RT;
+    rt_tasks += realtime;
+    // Nothing overtakes a queued task of its kind, and other work waits for every queued real-time task
+    deque<RtRequest_t> & queue = realtime ? rt_queue : be_queue;
+    if(queue.empty() && (realtime || rt_queue.empty()) && Dispatch(now, request))
+        return;
+    queue.push_back(request);
+    (realtime ? rt_queued : be_queued)++;
+}
+
+void Realtime::TasksCompleted(Time_t now, span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        auto it = running.find(task_id);
+        if(it == running.end())
+            continue;
+        auto [machine_id, realtime] = it->second;
+        if(realtime) {
+            machines[machine_id].rt_running--;
+            rt_violations += IsSLAViolation(task_id);
+        }
+        else {
+            machines[machine_id].be_running--;
+        }
+        running.erase(it);
+    }
+    // Strict priority: other work only gets the freed cores once no real-time task waits
+    while(!rt_queue.empty() && Dispatch(now, rt_queue.front()))
+        rt_queue.pop_front();
+    if(!rt_queue.empty())
+        return;
+    for(unsigned i = 0; i < machines.size(); i++)
+        Release(MachineId_t(i));
+    while(!be_queue.empty() && Dispatch(now, be_queue.front()))
+        be_queue.pop_front();
+}
+
+void Realtime::Report() {
+    cout << "Realtime: " << rt_tasks << " LINUX_RT tasks, " << rt_violations << " SLA violations, " << rt_queued << " queued (mean wait "
+         << (rt_queued ? rt_wait / rt_queued / 1000 : 0) << "ms), peak " << peak_reserved << " cores reserved" << endl;
+    cout << "Realtime: " << be_queued << " other tasks queued for a free core (mean wait " << (be_queued ? be_wait / be_queued / 1000 : 0) << "ms)" << endl;
+}
+
+void Realtime::Shutdown() {
+    for(auto & machine: machines) {
+        if(machine.has_rt_vm)
+            VM_Shutdown(machine.rt_vm);
+        for(auto & [vm_type, vm_id]: machine.be_vms)
+            VM_Shutdown(vm_id);
+    }
+}
@@ -0,0 +1,73 @@
+//
+//  Realtime.hpp
+//  CloudSim
+//
+//  Core reservation for LINUX_RT VMs. A machine can reserve some of its
+//  cores for a LINUX_RT VM, and the rest serve everything else. No machine
+//  runs more tasks than it has cores: real-time tasks only run on a free
+//  reserved core and other work only on a free unreserved one. The
+//  simulator therefore never has to rotate tasks, so a real-time task is
+//  never preempted, and there are always unreserved cores that free up for
+//  a new reservation. Real-time tasks run at high priority. When no
+//  reserved core is free, a new reservation is made on the machine with
+//  the most free cores. When that fails too, the task waits in a queue,
+//  and other work is held back until that queue is empty. Reserved cores
+//  that sit idle are given back once no real-time task waits.
+//
+
+#ifndef Realtime_hpp
+#define Realtime_hpp
+
+#include <deque>
+#include <map>
+#include <span>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    VMId_t rt_vm;                           // Holds the reservation, created with the first one
+    bool has_rt_vm;
+    unsigned reserved;                      // Cores reserved for the LINUX_RT VM
+    unsigned rt_running;
+    unsigned be_running;                    // Tasks of the other VMs
+    map<VMType_t, VMId_t> be_vms;
+} RtMachine_t;
+
+typedef struct {
+    TaskId_t task_id;
+    Priority_t priority;
+    Time_t arrival;
+} RtRequest_t;
+
+class Realtime {
+public:
+    Realtime()                  {}
+    void     Init(unsigned reserve_cores);
+    void     NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void     Report();
+    bool     Reserve(MachineId_t machine_id, unsigned cores);
+    unsigned Reservable(MachineId_t machine_id);
+    void     Shutdown();
+    void     TasksCompleted(Time_t now, span<const TaskId_t> task_ids);
+private:
+    bool Dispatch(Time_t now, const RtRequest_t & request);
+    bool PlaceBestEffort(TaskId_t task_id, Priority_t priority);
+    bool PlaceRealtime(TaskId_t task_id);
+    void Release(MachineId_t machine_id);
+
+    unsigned reserve_cores;                 // Cores added to a machine's reservation at a time
+    vector<RtMachine_t> machines;
+    map<TaskId_t, pair<MachineId_t, bool> > running;   // Machine of every running task, and whether it is real-time
+    deque<RtRequest_t> rt_queue;
+    deque<RtRequest_t> be_queue;
+    uint64_t rt_tasks = 0;
+    uint64_t rt_violations = 0;
+    uint64_t rt_queued = 0;
+    uint64_t be_queued = 0;
+    double rt_wait = 0;                     // Time spent queued, summed over the tasks, in microseconds
+    double be_wait = 0;
+    unsigned peak_reserved = 0;
+};
+
+#endif /* Realtime_hpp */
@@ -0,0 +1,161 @@
+//
+//  Residency.cpp
+//  CloudSim
+//
+
+#include <map>
+#include <sstream>
+
+#include "InputBlocks.hpp"
+#include "Residency.hpp"
+
+static const char * s_state_names[S_STATES] = {"S0", "S0i1", "S1", "S2", "S3", "S4", "S5"};
+static const char * c_state_names[C_STATES] = {"C0", "C1", "C2", "C4"};
+
+static CPUState_t IdleCoreState(MachineState_t s_state) {
+    switch(s_state) {
+        case S0:
+        case S0i1:
+            return C1;
+        case S1:
+            return C2;
+        default:
+            return C4;
+    }
+}
+
+static double ToKWHour(double microjoules) {
+    return microjoules / 3600000000000.0;
+}
+
+static double CurvePower(const vector<double> & curve, double utilization) {
+    double position = min(utilization, 1.0) * double(curve.size() - 1);
+    unsigned segment = min(unsigned(position), unsigned(curve.size() - 2));
+    return curve[segment] + (curve[segment + 1] - curve[segment]) * (position - segment);
+}
+
+void Residency::Init(Time_t now) {
+    for(unsigned i = 0; i < Machine_GetTotal(); i++)
+        Track(MachineId_t(i), now);
+}
+
+void Residency::Track(MachineId_t machine_id, Time_t now) {
+    // Machines added while the simulation runs are tracked from their first observation
+    machines.resize(machine_id + 1, MachineResidency_t{});
+    last.resize(machine_id + 1);
+    curves.resize(machine_id + 1);
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    last[machine_id] = Observation_t{now, Machine_GetEnergy(machine_id), info.s_state, info.p_state, min(info.active_tasks, info.num_cpus), info.num_cpus};
+}
+
+void Residency::LoadPowerCurves(string path) {
+    // Machine ids follow the order of the machine classes in the input
+    vector<unsigned> class_sizes;
+    map<unsigned, vector<double> > class_curves;
+    for(auto & block: ReadInputBlocks(path)) {
+        if(block.type == "machine class") {
+            class_sizes.push_back(unsigned(stoul(block.fields["Number of machines"])));
+        }
+        else if(block.type == "power curve") {
+            vector<double> curve = ParseBracketedValues(block.fields["Power"]);
+            if(curve.size() < 2)
+                ThrowException("Residency::LoadPowerCurves(): A power curve needs at least two points, machine class ", block.fields["Machine class"]);
+            class_curves[unsigned(stoul(block.fields["Machine class"]))] = curve;
+        }
+    }
+    unsigned first = 0;
+    for(unsigned machine_class = 0; machine_class < class_sizes.size(); machine_class++) {
+        for(unsigned i = first; i < first + class_sizes[machine_class] && i < curves.size(); i++)
+            curves[i] = class_curves[machine_class];
+        first += class_sizes[machine_class];
+    }
+    for(auto & [machine_class, curve]: class_curves) {
+        if(machine_class >= class_sizes.size())
+            ThrowException("Residency::LoadPowerCurves(): No machine class ", machine_class);
+    }
+    curves_loaded = true;
+}
+
+void Residency::Observe(MachineId_t machine_id, Time_t now) {
+    if(machine_id >= machines.size()) {
+        Track(machine_id, now);
+        return;
+    }
+    Observation_t & prev = last[machine_id];
+    MachineResidency_t & residency = machines[machine_id];
+    Time_t elapsed = now - prev.time;
+    uint64_t energy = Machine_GetEnergy(machine_id);
+    double consumed = energy > prev.energy ? double(energy - prev.energy) : 0;
+
+    residency.s_time[prev.s_state] += elapsed;
+    residency.s_energy[prev.s_state] += consumed;
+    if(prev.s_state == S0) {
+        residency.p_time[prev.p_state] += elapsed;
+        if(prev.busy)
+            residency.active_energy[prev.p_state] += consumed;
+        else
+            residency.idle_energy += consumed;
+    }
+    // Between observations the utilization is taken as the one seen at the first
+    if(prev.s_state == S0 && !curves[machine_id].empty())
+        residency.curve_energy += CurvePower(curves[machine_id], double(prev.busy) / prev.num_cpus) * double(elapsed);
+    else
+        residency.curve_energy += consumed;
+    residency.c_time[C0] += uint64_t(prev.busy) * elapsed;
+    residency.c_time[IdleCoreState(prev.s_state)] += uint64_t(prev.num_cpus - prev.busy) * elapsed;
+
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    prev = Observation_t{now, energy, info.s_state, info.p_state, info.s_state == S0 ? min(info.active_tasks, info.num_cpus) : 0, info.num_cpus};
+}
+
+void Residency::ObserveAll(Time_t now) {
+    for(unsigned i = 0; i < Machine_GetTotal(); i++)
+        Observe(MachineId_t(i), now);
+}
+
+void Residency::Report(Time_t now) {
+    ObserveAll(now);
+    MachineResidency_t total = {};
+    for(unsigned i = 0; i < machines.size(); i++) {
+        MachineResidency_t & residency = machines[i];
+        ostringstream line;
+        line << "Residency::Report(): Machine " << i << " energy";
+        for(unsigned s = 0; s < S_STATES; s++) {
+            total.s_time[s] += residency.s_time[s];
+            total.s_energy[s] += residency.s_energy[s];
+            if(residency.s_time[s])
+                line << " " << s_state_names[s] << " " << ToKWHour(residency.s_energy[s]) << "KW-Hour over " << double(residency.s_time[s]) / 1000000 << "s";
+        }
+        for(unsigned p = 0; p < P_STATES; p++) {
+            total.p_time[p] += residency.p_time[p];
+            total.active_energy[p] += residency.active_energy[p];
+        }
+        for(unsigned c = 0; c < C_STATES; c++)
+            total.c_time[c] += residency.c_time[c];
+        total.idle_energy += residency.idle_energy;
+        total.curve_energy += residency.curve_energy;
+        if(curves_loaded)
+            line << " power curve " << ToKWHour(residency.curve_energy) << "KW-Hour";
+        SimOutput(line.str(), 1);
+    }
+
+    cout << "Machine time by S-state:";
+    for(unsigned s = 0; s < S_STATES; s++)
+        cout << " " << s_state_names[s] << " " << double(total.s_time[s]) / 1000000 << "s";
+    cout << endl << "Energy by S-state:";
+    for(unsigned s = 0; s < S_STATES; s++)
+        cout << " " << s_state_names[s] << " " << ToKWHour(total.s_energy[s]) << "KW-Hour";
+    cout << endl << "S0 energy: idle " << ToKWHour(total.idle_energy) << "KW-Hour, active";
+    for(unsigned p = 0; p < P_STATES; p++)
+        cout << " P" << p << " " << ToKWHour(total.active_energy[p]) << "KW-Hour (" << double(total.p_time[p]) / 1000000 << "s)";
+    cout << endl << "Core time by C-state:";
+    for(unsigned c = 0; c < C_STATES; c++)
+        cout << " " << c_state_names[c] << " " << double(total.c_time[c]) / 1000000 << "s";
+    cout << endl;
+    if(curves_loaded) {
+        double table = 0;
+        for(unsigned s = 0; s < S_STATES; s++)
+            table += total.s_energy[s];
+        cout << "Power curve energy: " << ToKWHour(total.curve_energy) << "KW-Hour against " << ToKWHour(table) << "KW-Hour from the state tables" << endl;
+    }
+}
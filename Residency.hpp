@@ -0,0 +1,62 @@
+//
+//  Residency.hpp
+//  CloudSim
+//
+//  Time-in-state and energy-by-state accounting. Machines are observed on
+//  every periodic check and state change completion. The time and energy
+//  between two observations go to the state seen at the first one. Energy
+//  comes from Machine_GetEnergy, which the machines bring up to date on
+//  every timer tick. Cores are indistinguishable from outside the machine,
+//  so C-state residency is kept as core time per state: busy cores in C0,
+//  the rest in the C-state implied by the S-state. A machine class can also
+//  have a piecewise-linear power curve over utilization, which is evaluated
+//  at every observation from the busy cores and integrated next to the
+//  energy the machines report.
+//
+
+#ifndef Residency_hpp
+#define Residency_hpp
+
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    Time_t s_time[S_STATES];                // Time spent in each S-state
+    Time_t p_time[P_STATES];                // Time spent in S0 at each P-state
+    uint64_t c_time[C_STATES];              // Core time spent in each C-state
+    double s_energy[S_STATES];              // Energy consumed in each S-state (microjoules)
+    double idle_energy;                     // Energy consumed in S0 with no task running
+    double active_energy[P_STATES];         // Energy consumed in S0 running tasks, by P-state
+    double curve_energy;                    // Energy from the power curve in S0, from the S-state table otherwise
+} MachineResidency_t;
+
+class Residency {
+public:
+    Residency()                 {}
+    const MachineResidency_t & GetMachine(MachineId_t machine_id) { return machines[machine_id]; }
+    void Init(Time_t now);
+    void LoadPowerCurves(string path);
+    void Observe(MachineId_t machine_id, Time_t now);
+    void ObserveAll(Time_t now);
+    void Report(Time_t now);
+private:
+    typedef struct {
+        Time_t time;
+        uint64_t energy;
+        MachineState_t s_state;
+        CPUPerformance_t p_state;
+        unsigned busy;
+        unsigned num_cpus;
+    } Observation_t;
+
+    void Track(MachineId_t machine_id, Time_t now);
+
+    vector<MachineResidency_t> machines;
+    vector<Observation_t> last;
+    vector<vector<double> > curves;         // Watts at evenly spaced utilizations from 0 to 1, by machine, empty without a curve
+    bool curves_loaded = false;
+};
+
+#endif /* Residency_hpp */
@@ -0,0 +1,199 @@
+//
+//  Sampling.cpp
+//  CloudSim
+//
+
+#include <cmath>
+
+#include "Internal_Interfaces.h"
+#include "Sampling.hpp"
+
+#define Z_95            1.96                // Normal quantile of the 95% confidence intervals
+
+static double ToKWHour(double microjoules) {
+    return microjoules / 3600000000000.0;
+}
+
+void Sampling::Init(double fraction, bool validate) {
+    this->validate = validate;
+    unsigned total = Machine_GetTotal();
+    start_energy.resize(total);
+    for(unsigned i = 0; i < total; i++) {
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+        start_energy[i] = Machine_GetEnergy(MachineId_t(i));
+        auto it = strata.begin();
+        while(it != strata.end() && !(it->cpu == info.cpu && it->num_cpus == info.num_cpus && it->memory_size == info.memory_size && it->gpus == info.gpus))
+            it++;
+        if(it == strata.end())
+            it = strata.insert(strata.end(), Stratum_t{info.cpu, info.num_cpus, info.memory_size, info.gpus, {}, {}, {}, 0, 0, 0, {}});
+        it->machines.push_back(MachineId_t(i));
+    }
+
+    map<CPUType_t, unsigned> cpu_cores;
+    for(unsigned s = 0; s < strata.size(); s++) {
+        // Systematic sample, at least two machines per class so that its variance can be estimated
+        Stratum_t & stratum = strata[s];
+        unsigned size = unsigned(stratum.machines.size());
+        unsigned count = min(size, max(2u, unsigned(ceil(fraction * size))));
+        for(unsigned i = 0; i < size; i++) {
+            MachineId_t machine_id = stratum.machines[i];
+            if(stratum.sample.size() < count && i * count >= stratum.sample.size() * size) {
+                stratum.sample.push_back(machine_id);
+            }
+            else {
+                stratum.others.push_back(machine_id);
+                if(!validate)
+                    Machine_SetState(machine_id, S5);
+            }
+        }
+        cpu_strata[stratum.cpu].push_back(s);
+        cpu_cores[stratum.cpu] += size * stratum.num_cpus;
+    }
+    for(auto & stratum: strata)
+        stratum.weight = double(stratum.machines.size() * stratum.num_cpus) / cpu_cores[stratum.cpu];
+    SimOutput("Sampling::Init(): " + to_string(strata.size()) + " machine classes, sampling " + to_string(fraction), 1);
+}
+
+int Sampling::Place(const vector<MachineId_t> & candidates, TaskId_t task_id) {
+    // Least loaded machine that has the memory for the task, or the least loaded one if none has
+    unsigned memory = GetTaskMemory(task_id);
+    int best = -1, fallback = -1;
+    double best_load = 0, fallback_load = 0;
+    for(auto machine_id: candidates) {
+        MachineInfo_t info = Machine_GetInfo(machine_id);
+        if(info.s_state != S0)
+            continue;
+        double load = double(info.active_tasks) / info.num_cpus;
+        if(fallback < 0 || load < fallback_load) {
+            fallback = int(machine_id);
+            fallback_load = load;
+        }
+        if(info.memory_used + memory <= info.memory_size && (best < 0 || load < best_load)) {
+            best = int(machine_id);
+            best_load = load;
+        }
+    }
+    return best >= 0 ? best : fallback;
+}
+
+unsigned Sampling::PickStratum(TaskId_t task_id) {
+    // Smooth weighted round robin: every stratum gains its weight, and the one with the most credit takes the task
+    auto it = cpu_strata.find(RequiredCPUType(task_id));
+    if(it == cpu_strata.end())
+        ThrowException("Sampling::NewTask(): No machine for the CPU type of task ", task_id);
+    unsigned best = it->second[0];
+    for(auto s: it->second) {
+        strata[s].credit += strata[s].weight;
+        if(strata[s].credit > strata[best].credit)
+            best = s;
+    }
+    strata[best].credit -= 1;
+    return best;
+}
+
+void Sampling::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    if(task_id >= sampled.size())
+        sampled.resize(task_id + 1, -1);
+    unsigned s = PickStratum(task_id);
+    Stratum_t & stratum = strata[s];
+
+    // Every stratum gets the share of its arrivals that matches the share of its machines in the sample
+    stratum.sample_credit += double(stratum.sample.size()) / stratum.machines.size();
+    bool in_sample = stratum.sample_credit >= 1;
+    if(in_sample)
+        stratum.sample_credit -= 1;
+    sampled[task_id] = in_sample ? int(s) : -1;
+    left_out += !in_sample;
+
+    if(!in_sample && !validate) {
+        // No machine runs the task, it only has to leave the simulator's count of active tasks
+        CompleteTask(task_id);
+        return;
+    }
+    int machine_id = Place(in_sample ? stratum.sample : stratum.others, task_id);
+    if(machine_id < 0)
+        ThrowException("Sampling::NewTask(): No machine is up for task ", task_id);
+
+    VMType_t vm_type = RequiredVMType(task_id);
+    auto vm = vms.find({MachineId_t(machine_id), vm_type});
+    VMId_t vm_id;
+    if(vm == vms.end()) {
+        vm_id = VM_Create(vm_type, stratum.cpu);
+        VM_Attach(vm_id, MachineId_t(machine_id));
+        vms[{MachineId_t(machine_id), vm_type}] = vm_id;
+    }
+    else {
+        vm_id = vm->second;
+    }
+    PlaceTask(vm_id, task_id, priority);
+    SimOutput("Sampling::NewTask(): Task " + to_string(task_id) + (in_sample ? " sampled" : " not sampled") + " at " + to_string(now), 4);
+}
+
+void Sampling::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        if(task_id >= sampled.size() || sampled[task_id] < 0)
+            continue;
+        SampleSLA_t & stats = strata[sampled[task_id]].sla[RequiredSLA(task_id)];
+        stats.completed++;
+        if(IsSLAViolation(task_id))
+            stats.violations++;
+    }
+}
+
+void Sampling::Report() {
+    double estimate = 0, variance = 0, actual = 0;
+    unsigned sample_size = 0;
+    for(auto & stratum: strata) {
+        double size = double(stratum.machines.size()), count = double(stratum.sample.size());
+        double sum = 0, squares = 0;
+        for(auto machine_id: stratum.sample) {
+            double energy = double(Machine_GetEnergy(machine_id) - start_energy[machine_id]);
+            sum += energy;
+            squares += energy * energy;
+        }
+        double mean = sum / count;
+        double spread = count > 1 ? (squares - sum * mean) / (count - 1) : 0;
+        estimate += size * mean;
+        variance += size * size * (1 - count / size) * max(spread, 0.0) / count;
+        for(auto machine_id: stratum.machines)
+            actual += double(Machine_GetEnergy(machine_id) - start_energy[machine_id]);
+        sample_size += unsigned(stratum.sample.size());
+    }
+    double half_width = Z_95 * sqrt(variance);
+
+    uint64_t in_sample = 0;
+    for(auto & stratum: strata) {
+        for(auto & stats: stratum.sla)
+            in_sample += stats.completed;
+    }
+    uint64_t tasks = in_sample + left_out;
+    cout << "Sampled simulation: " << sample_size << " of " << start_energy.size() << " machines, " << in_sample << " of " << tasks << " completed tasks in the sample" << endl;
+    if(!validate)
+        cout << "Sampled simulation: the SLA report and total energy above are not valid in sampled mode, use the estimates below" << endl;
+    cout << "Sampled simulation energy estimate: " << ToKWHour(estimate) << "KW-Hour +/- " << ToKWHour(half_width) << "KW-Hour (95%)" << endl;
+    for(unsigned s = SLA0; s < SLA3; s++) {
+        // A stratum stands for the tasks it left out as well, so its counts are scaled by the inverse of its sampled share
+        double completed = 0, violations = 0;
+        uint64_t count = 0;
+        for(auto & stratum: strata) {
+            double scale = double(stratum.machines.size()) / stratum.sample.size();
+            completed += scale * stratum.sla[s].completed;
+            violations += scale * stratum.sla[s].violations;
+            count += stratum.sla[s].completed;
+        }
+        if(!count)
+            continue;
+        double rate = violations / completed;
+        cout << "Sampled simulation SLA" << s << " violations: " << 100 * rate << "% +/- " << 100 * Z_95 * sqrt(rate * (1 - rate) / count) << "% (95%)" << endl;
+    }
+    if(validate) {
+        double error = actual > 0 ? 100 * (estimate - actual) / actual : 0;
+        cout << "Sampled simulation validation: full cluster energy " << ToKWHour(actual) << "KW-Hour, estimate off by " << error << "% ("
+             << (fabs(estimate - actual) <= half_width ? "inside" : "outside") << " the interval)" << endl;
+    }
+}
+
+void Sampling::Shutdown() {
+    for(auto & [key, vm_id]: vms)
+        VM_Shutdown(vm_id);
+}
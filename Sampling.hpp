@@ -0,0 +1,70 @@
+//
+//  Sampling.hpp
+//  CloudSim
+//
+//  Stratified sampled simulation. The machines are split into strata by
+//  machine class, and a systematic sample of every stratum is simulated.
+//  The arrivals of a CPU type are dealt to its strata in proportion to
+//  their cores, which is how a placement that evens out the tasks per core
+//  spreads them, and a task only ever runs on a machine of its stratum.
+//  Every stratum places the share of its tasks that matches the share of
+//  its machines in the sample. The tasks left out of the sample are never
+//  placed, they are marked complete on arrival. Cluster energy and SLA
+//  violation rates are extrapolated per stratum, each weighted by the
+//  inverse of its sampled share, with 95% confidence intervals. The
+//  simulator's own SLA report counts the retired tasks as met and its
+//  energy covers the sampled machines only, so in sampled mode only the
+//  estimate is meaningful.
+//  In validation mode every machine and task is simulated, with the same
+//  placement, and the extrapolation is compared with the full cluster.
+//
+
+#ifndef Sampling_hpp
+#define Sampling_hpp
+
+#include <map>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    uint64_t completed;                     // Sampled tasks completed, per SLA
+    uint64_t violations;
+} SampleSLA_t;
+
+typedef struct {
+    CPUType_t cpu;
+    unsigned num_cpus;
+    unsigned memory_size;
+    bool gpus;
+    vector<MachineId_t> machines;           // Every machine of the class
+    vector<MachineId_t> sample;             // Machines simulated in sampled mode
+    vector<MachineId_t> others;             // Machines only simulated in validation mode
+    double weight;                          // Share of the cores of its CPU type
+    double credit;                          // Smooth weighted round robin over the strata of the CPU type
+    double sample_credit;                   // Systematic sampling of the arrivals of the stratum
+    SampleSLA_t sla[NUM_SLAS];
+} Stratum_t;
+
+class Sampling {
+public:
+    Sampling()                  {}
+    void Init(double fraction, bool validate);
+    void NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void Report();
+    void Shutdown();
+    void TasksCompleted(span<const TaskId_t> task_ids);
+private:
+    int      Place(const vector<MachineId_t> & candidates, TaskId_t task_id);
+    unsigned PickStratum(TaskId_t task_id);
+
+    bool validate;
+    vector<Stratum_t> strata;
+    vector<uint64_t> start_energy;          // Energy of every machine when sampling started
+    map<CPUType_t, vector<unsigned> > cpu_strata;
+    vector<int> sampled;                    // Stratum of every task in the sample, -1 for the others, indexed by task id
+    uint64_t left_out = 0;                  // Tasks not in the sample
+    map<pair<MachineId_t, VMType_t>, VMId_t> vms;  // One VM per machine and VM type, created on first placement
+};
+
+#endif /* Sampling_hpp */
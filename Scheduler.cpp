@@ -5,10 +5,74 @@
 //  Created by ELMOOTAZBELLAH ELNOZAHY on 10/20/24.
 //
 
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <tuple>
+
+#include "DecisionLog.hpp"
+#include "PolicyCoroutine.hpp"
 #include "Scheduler.hpp"
+#include "TimerWheel.hpp"
 
 static bool migrating = false;
+static Time_t migration_start = 600000;     // Tenth periodic check
 static unsigned active_machines = 16;
+static bool omega_mode = false;             // Place tasks with parallel optimistic scheduler instances, one per SLA type
+static unsigned omega_tasks_per_core = 4;   // Core capacity enforced by the omega commit check
+static bool speed_scaling = false;          // Run every machine at the slowest P-state that meets its deadlines
+static string decision_log = "";            // When set, compare the callbacks with the previous run logged to this file
+static unsigned decision_checkpoint_interval = 10;  // Periodic checks between checkpoint marks in the decision log
+static bool steady_state = false;           // Estimate steady-state power and SLA violation rate with confidence intervals
+static bool steady_state_stop = false;      // End the run as soon as the steady-state estimates have converged
+static double steady_state_precision = 0.05;    // Target relative half-width of the 95% confidence intervals
+static double sampling_fraction = 0;        // When non-zero, simulate only this share of every machine class and extrapolate
+static bool sampling_validate = false;      // Simulate the whole cluster anyway and compare it with the extrapolation
+static unsigned rare_event_replications = 0;    // When non-zero, estimate the SLA0 violation probability by splitting, over this many replications
+static unsigned rare_event_split = 3;       // Copies made of a run at every stress level it crosses
+static vector<double> rare_event_levels = {1.2, 1.4, 1.6};  // Stress levels: projected completion over time left, worst running SLA0 task
+static string flow_input = "";              // Input file whose WEB_REQUEST task classes are served as flows instead of run as tasks
+static bool task_templates = false;         // Report the recurring task templates found in the arrivals
+static bool web_service = false;            // Serve the web requests from an autoscaled replica set
+static ServiceConfig_t service_config = {LINUX, X86, SLA0, LEAST_OUTSTANDING_ROUTING, 2, 8, 8, 2000000, 16, 4};
+static bool elastic_cluster = false;        // Place tasks on the elastic cluster, bursting to provisioned machines under load
+static vector<ElasticPool_t> elastic_pools = {{0, 5000000, 50000, 3.0, true, 8}};  // Burst pool of machines shaped like machine 0
+static double elastic_burst_load = 2;       // Tasks per core on premises above which tasks go to burst machines
+static Time_t elastic_idle_time = 2000000;  // Idle time after which a burst machine is retired
+static double energy_price = 0.15;          // Dollars per KW-Hour of metered energy
+static string efficiency_input = "";        // When set, apply the efficiency blocks of this input file to every task
+static string power_curve_input = "";       // When set, integrate the power curves of this input file over machine utilization
+static bool thermal_model = false;          // Track machine temperatures, throttle hot machines and give cool ones turbo
+static ThermalConfig_t thermal_config = {25, 0.2, 50, 70, 5, 8, 0.005, 1.2, 1.4, 60};
+static string thermal_trace = "";           // When set, write the machine temperatures to this CSV file
+static bool facility_model = false;         // Add cooling, power distribution and building load to the IT energy
+static FacilityConfig_t facility_config = {20, 18, 0.08, 5, 0.15, 0.06, 300};
+static string facility_input = "";          // When set, read the ambient temperature series from this input file
+static string federation_input = "";        // When set, place tasks across the sites of this input file
+static double federation_spill_load = 1;    // Tasks per core at home above which a task may be sent to another site
+static unsigned numa_nodes = 1;             // NUMA nodes per machine, above one tasks pay for the memory that is not on their node
+static double numa_remote_slowdown = 0.3;   // Extra run time of a task whose memory is all on remote nodes
+static bool rt_reservation = false;         // Run LINUX_RT tasks on cores reserved for them and never shared with other work
+static unsigned rt_reserve_cores = 2;       // Cores a machine adds to its LINUX_RT reservation at a time
+static string shares_input = "";            // Input file with "vm share:" blocks, enables per-VM CPU shares and caps
+static string overbook_input = "";          // Input file with "usage model:" blocks, enables statistical overbooking
+static double overbook_target = 0.01;       // Overflow probability a machine may take when overbooked
+static double overbook_declared_limit = 1.5; // Declared memory over the memory of a machine it may hold at the start, lowered by MemoryWarning
+static double overbook_cpu_limit = 2;       // Tasks per core admitted at the start, adapted by the SLA outcomes
+
+static PolicyTask MigrateAfterWarmup() {
+    // Move VM 1 to machine 9 once the cluster has warmed up. New tasks go to VM 0 while it is in flight
+    co_await Timer(migration_start);
+    migrating = true;
+    VM_Migrate(1, 9);
+    co_await Migration(1);
+    migrating = false;
+}
+
+bool Scheduler::HasConverged() {
+    // Once converged, running further only narrows confidence intervals that are already tight enough
+    return steady_state && steady_state_stop && steady.HasConverged();
+}
 
 void Scheduler::Init() {
     // Find the parameters of the clusters
@@ -21,6 +85,49 @@ void Scheduler::Init() {
     // 
     SimOutput("Scheduler::Init(): Total number of machines is " + to_string(Machine_GetTotal()), 3);
     SimOutput("Scheduler::Init(): Initializing scheduler", 1);
+    residency.Init(Now());
+    if(!power_curve_input.empty())
+        residency.LoadPowerCurves(power_curve_input);
+    if(thermal_model)
+        thermal.Init(Now(), thermal_config, thermal_trace, &slowdown);
+    if(facility_model)
+        facility.Init(Now(), facility_config, facility_input);
+    if(numa_nodes > 1)
+        numa.Init(numa_nodes, numa_remote_slowdown, &slowdown);
+    if(steady_state)
+        steady.Init(Now(), steady_state_precision);
+    if(!efficiency_input.empty())
+        efficiency.Init(efficiency_input, &slowdown);
+    if(sampling_fraction > 0) {
+        // The sample replaces the fixed layout below and takes over the placement
+        sampling.Init(sampling_fraction, sampling_validate);
+        return;
+    }
+    if(rare_event_replications) {
+        rare.Init(rare_event_replications, rare_event_split, rare_event_levels);
+        return;
+    }
+    if(elastic_cluster) {
+        // Every machine of the input stays up as the premises, the elastic cluster grows past them
+        elastic.Init(elastic_pools, elastic_burst_load, elastic_idle_time, energy_price);
+        return;
+    }
+    if(!federation_input.empty()) {
+        federation.Init(federation_input, federation_spill_load);
+        return;
+    }
+    if(rt_reservation) {
+        realtime.Init(rt_reserve_cores);
+        return;
+    }
+    if(!shares_input.empty()) {
+        shares.Init(shares_input);
+        return;
+    }
+    if(!overbook_input.empty()) {
+        overbooking.Init(overbook_input, overbook_target, overbook_declared_limit, overbook_cpu_limit);
+        return;
+    }
     for(unsigned i = 0; i < active_machines; i++)
         vms.push_back(VM_Create(LINUX, X86));
     for(unsigned i = 0; i < active_machines; i++) {
@@ -29,12 +136,14 @@ void Scheduler::Init() {
     for(unsigned i = 0; i < active_machines; i++) {
         VM_Attach(vms[i], machines[i]);
     }
+    if(!flow_input.empty())
+        flows.Init(flow_input);
+    if(omega_mode)
+        omega.Init(NUM_SLAS, omega_tasks_per_core, &templates);
+    if(web_service)
+        service.Init(Now(), service_config);
+    MigrateAfterWarmup();
 
-    bool dynamic = false;
-    if(dynamic)
-        for(unsigned i = 0; i<4 ; i++)
-            for(unsigned j = 0; j < 8; j++)
-                Machine_SetCorePerformance(MachineId_t(0), j, P3);
     // Turn off the ARM machines
     for(unsigned i = 24; i < Machine_GetTotal(); i++)
         Machine_SetState(MachineId_t(i), S5);
@@ -42,8 +151,23 @@ void Scheduler::Init() {
     SimOutput("Scheduler::Init(): VM ids are " + to_string(vms[0]) + " ahd " + to_string(vms[1]), 3);
 }
 
+void Scheduler::MachineStateChanged(Time_t now, MachineId_t machine_id) {
+    // The machine reached the S-state requested earlier
+    residency.Observe(machine_id, now);
+}
+
+void Scheduler::MemoryWarning(Time_t now, MachineId_t machine_id) {
+    // The machine holds more declared memory than it has
+    if(!overbook_input.empty())
+        overbooking.MemoryWarning(machine_id);
+}
+
 void Scheduler::MigrationComplete(Time_t time, VMId_t vm_id) {
     // Update your data structure. The VM now can receive new tasks
+    if(speed_scaling)
+        speed.MigrationComplete(time, vm_id);
+    if(!federation_input.empty())
+        federation.MigrationComplete(vm_id);
 }
 
 void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
@@ -65,12 +189,63 @@ void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
     //
     // Other possibilities as desired
     Priority_t priority = (task_id == 0 || task_id == 64)? HIGH_PRIORITY : MID_PRIORITY;
-    if(migrating) {
-        VM_AddTask(vms[0], task_id, priority);
+    // Only the omega instances and the template report use the interned form of the task
+    TaskInstance_t instance = omega_mode || task_templates ? templates.Instance(now, task_id) : TaskInstance_t{task_id, 0, now};
+    // The flows are bound to the VMs of the fixed layout, the modes that take over the placement have none
+    if(!flow_input.empty() && !vms.empty() && flows.Serve(now, task_id, migrating ? vms[0] : vms[task_id % active_machines]))
+        return;
+    if(!efficiency_input.empty())
+        efficiency.TaskArrived(now, task_id);
+    if(web_service && service.Route(now, task_id, priority))
+        return;
+    if(sampling_fraction > 0) {
+        sampling.NewTask(now, task_id, priority);
+        return;
+    }
+    if(rare_event_replications) {
+        rare.NewTask(now, task_id, priority);
+        return;
+    }
+    if(elastic_cluster) {
+        elastic.NewTask(now, task_id, priority);
+        return;
+    }
+    if(!federation_input.empty()) {
+        federation.NewTask(now, task_id, priority);
+        return;
     }
-    else {
-        VM_AddTask(vms[task_id % active_machines], task_id, priority);
-    }// Skeleton code, you need to change it according to your algorithm
+    if(rt_reservation) {
+        realtime.NewTask(now, task_id, priority);
+        return;
+    }
+    if(!shares_input.empty()) {
+        shares.NewTask(now, task_id, priority);
+        return;
+    }
+    if(!overbook_input.empty()) {
+        overbooking.NewTask(now, task_id, priority);
+        return;
+    }
+    if(omega_mode) {
+        omega.Submit(now, instance, priority);
+        omega.Flush(now);
+        return;
+    }
+    VMId_t vm_id = migrating ? vms[0] : vms[task_id % active_machines];
+    // VM_GetInfo copies the task list of the VM, so the machine is only looked up for the modules that need it
+    MachineId_t machine_id = speed_scaling || thermal_model || numa_nodes > 1 || !efficiency_input.empty() ? VM_GetInfo(vm_id).machine_id : 0;
+    if(thermal_model)
+        thermal.TaskPlaced(task_id, machine_id);
+    if(numa_nodes > 1)
+        numa.Place(task_id, machine_id, numa.PickNode(machine_id, task_id));
+    if(!efficiency_input.empty())
+        efficiency.Placed(task_id, machine_id);
+    // The instructions are rewritten once, with the factors of every model that placed the task
+    if(thermal_model || numa_nodes > 1 || !efficiency_input.empty())
+        slowdown.Apply(task_id, machine_id, false);
+    PlaceTask(vm_id, task_id, priority); // Skeleton code, you need to change it according to your algorithm
+    if(speed_scaling)
+        speed.TaskArrived(now, task_id, machine_id);
 }
 
 void Scheduler::PeriodicCheck(Time_t now) {
@@ -78,6 +253,31 @@ void Scheduler::PeriodicCheck(Time_t now) {
     // SchedulerCheck is called periodically by the simulator to allow you to monitor, make decisions, adjustments, etc.
     // Unlike the other invocations of the scheduler, this one doesn't report any specific event
     // Recommendation: Take advantage of this function to do some monitoring and adjustments as necessary
+    residency.ObserveAll(now);
+    if(omega_mode)
+        omega.Flush(now);
+    if(speed_scaling)
+        speed.PeriodicCheck(now);
+    if(!efficiency_input.empty())
+        efficiency.PeriodicCheck(now);
+    if(thermal_model)
+        thermal.PeriodicCheck(now);
+    if(facility_model)
+        facility.PeriodicCheck(now);
+    if(steady_state)
+        steady.PeriodicCheck(now);
+    if(!flow_input.empty())
+        flows.PeriodicCheck(now);
+    if(web_service)
+        service.PeriodicCheck(now);
+    if(rare_event_replications)
+        rare.PeriodicCheck(now);
+    if(elastic_cluster)
+        elastic.PeriodicCheck(now);
+    if(!federation_input.empty())
+        federation.PeriodicCheck(now);
+    if(!overbook_input.empty())
+        overbooking.PeriodicCheck(now);
 }
 
 void Scheduler::Shutdown(Time_t time) {
@@ -85,6 +285,57 @@ void Scheduler::Shutdown(Time_t time) {
     // Report about the total energy consumed
     // Report about the SLA compliance
     // Shutdown everything to be tidy :-)
+    residency.Report(time);
+    if(speed_scaling)
+        speed.Report(time);
+    if(steady_state)
+        steady.Report();
+    if(!flow_input.empty())
+        flows.Report();
+    if(task_templates)
+        templates.Report();
+    if(!efficiency_input.empty())
+        efficiency.Report();
+    if(thermal_model)
+        thermal.Report();
+    if(facility_model)
+        facility.Report(time);
+    if(numa_nodes > 1)
+        numa.Report();
+    if(web_service) {
+        service.Report(time);
+        service.Shutdown();
+    }
+    if(sampling_fraction > 0) {
+        sampling.Report();
+        sampling.Shutdown();
+    }
+    if(rare_event_replications)
+        rare.Report();
+    if(elastic_cluster) {
+        elastic.Report(time);
+        elastic.Shutdown();
+    }
+    if(!federation_input.empty()) {
+        federation.Report();
+        federation.Shutdown();
+    }
+    if(rt_reservation) {
+        realtime.Report();
+        realtime.Shutdown();
+    }
+    if(!shares_input.empty()) {
+        shares.Report();
+        shares.Shutdown();
+    }
+    if(!overbook_input.empty()) {
+        overbooking.Report();
+        overbooking.Shutdown();
+    }
+    if(omega_mode) {
+        omega.Report();
+        omega.Shutdown();
+    }
     for(auto & vm: vms) {
         VM_Shutdown(vm);
     }
@@ -92,58 +343,163 @@ void Scheduler::Shutdown(Time_t time) {
     SimOutput("SimulationComplete(): Time is " + to_string(time), 4);
 }
 
-void Scheduler::TaskComplete(Time_t now, TaskId_t task_id) {
+void Scheduler::TasksComplete(Time_t now, span<const TaskId_t> task_ids) {
     // Do any bookkeeping necessary for the data structures
     // Decide if a machine is to be turned off, slowed down, or VMs to be migrated according to your policy
     // This is an opportunity to make any adjustments to optimize performance/energy
-    SimOutput("Scheduler::TaskComplete(): Task " + to_string(task_id) + " is complete at " + to_string(now), 4);
+    // All the tasks of a machine that finished at the same time come in one batch, so the freed capacity can be used in one decision
+    // The batch arrives after the tasks finished, now is the time of the decision, not of the completions
+    SimOutput("Scheduler::TasksComplete(): " + to_string(task_ids.size()) + " tasks completed, handled at " + to_string(now), 4);
+    if(speed_scaling)
+        speed.TasksCompleted(now, task_ids);
+    if(steady_state)
+        steady.TasksCompleted(task_ids);
+    if(!efficiency_input.empty())
+        efficiency.TasksCompleted(task_ids);
+    if(thermal_model)
+        thermal.TasksCompleted(task_ids);
+    if(numa_nodes > 1)
+        numa.TasksCompleted(task_ids);
+    if(thermal_model || numa_nodes > 1 || !efficiency_input.empty())
+        slowdown.TasksCompleted(task_ids);
+    if(rt_reservation)
+        realtime.TasksCompleted(now, task_ids);
+    if(!shares_input.empty())
+        shares.TasksCompleted(now, task_ids);
+    if(!overbook_input.empty())
+        overbooking.TasksCompleted(now, task_ids);
+    if(web_service)
+        service.TasksCompleted(now, task_ids);
+    if(sampling_fraction > 0)
+        sampling.TasksCompleted(task_ids);
+    if(rare_event_replications)
+        rare.TasksCompleted(task_ids);
+}
+
+void Scheduler::TimerExpired(Time_t now, uint64_t cookie) {
+    // A timer requested through ScheduleSchedulerTimer() has expired. The cookie identifies what it was for
+    // Use timers instead of scanning the whole cluster in PeriodicCheck, e.g. to re-evaluate or park a machine later
+    if(web_service && (cookie & SERVICE_TIMER_FLAG))
+        service.TimerExpired(now, cookie);
+    if(elastic_cluster && (cookie & ELASTIC_TIMER_FLAG))
+        elastic.TimerExpired(now, cookie);
+    if(!federation_input.empty() && (cookie & FEDERATION_TIMER_FLAG))
+        federation.TimerExpired(now, cookie);
+    if(!flow_input.empty() && (cookie & FLOWS_TIMER_FLAG))
+        flows.TimerExpired(now, cookie);
 }
 
 // Public interface below
 
 static Scheduler Scheduler;
+static TimerWheel SchedulerTimers;
+static DecisionLog Decisions;
+static map<TaskId_t, VMId_t> placements;   // VM of every task placed and not yet completed
+static vector<pair<Time_t, TaskId_t> > completions;    // Completions not yet delivered in a batch
+
+static void DeliverCompletions() {
+    // A task added to a machine that time-slices more tasks than cores from inside a completion callback
+    // makes the simulator start a core twice and bail out, CompletionCallbackTest shows it. The batches
+    // are delivered from the next callback that is not a completion instead, which is up to one periodic
+    // check late when nothing else happens. The completions of a time are batched per machine
+    vector<pair<Time_t, TaskId_t> > pending;
+    pending.swap(completions);
+    map<VMId_t, MachineId_t> vm_machines;
+    vector<tuple<Time_t, MachineId_t, TaskId_t> > ordered;
+    for(auto [time, task_id]: pending) {
+        // Tasks not placed through PlaceTask share one batch per time, after the machines
+        MachineId_t machine_id = MachineId_t(-1);
+        auto it = placements.find(task_id);
+        if(it != placements.end()) {
+            auto vm = vm_machines.find(it->second);
+            if(vm == vm_machines.end())
+                vm = vm_machines.insert({it->second, VM_GetInfo(it->second).machine_id}).first;
+            machine_id = vm->second;
+            placements.erase(it);
+        }
+        ordered.push_back({time, machine_id, task_id});
+    }
+    sort(ordered.begin(), ordered.end());
+    vector<TaskId_t> batch;
+    for(unsigned i = 0; i < ordered.size(); i++) {
+        batch.push_back(get<2>(ordered[i]));
+        if(i + 1 == ordered.size() || get<0>(ordered[i + 1]) != get<0>(ordered[i]) || get<1>(ordered[i + 1]) != get<1>(ordered[i])) {
+            HandleTaskCompletionBatch(get<0>(ordered[i]), batch);
+            batch.clear();
+        }
+    }
+}
 
 void InitScheduler() {
     SimOutput("InitScheduler(): Initializing scheduler", 4);
+    if(!decision_log.empty())
+        Decisions.Init(decision_log, decision_checkpoint_interval);
     Scheduler.Init();
 }
 
 void HandleNewTask(Time_t time, TaskId_t task_id) {
     SimOutput("HandleNewTask(): Received new task " + to_string(task_id) + " at time " + to_string(time), 4);
+    Decisions.Record(ARRIVAL_RECORD, time, task_id);
+    DeliverCompletions();
+    SchedulerTimers.Advance(time, SchedulerTimer);
     Scheduler.NewTask(time, task_id);
 }
 
 void HandleTaskCompletion(Time_t time, TaskId_t task_id) {
     SimOutput("HandleTaskCompletion(): Task " + to_string(task_id) + " completed at time " + to_string(time), 4);
-    Scheduler.TaskComplete(time, task_id);
+    Decisions.Record(COMPLETION_RECORD, time, task_id);
+    completions.push_back({time, task_id});
+}
+
+void HandleTaskCompletionBatch(Time_t time, span<const TaskId_t> task_ids) {
+    SimOutput("HandleTaskCompletionBatch(): " + to_string(task_ids.size()) + " tasks completed at time " + to_string(time), 4);
+    Scheduler.TasksComplete(Now(), task_ids);
+    for(auto task_id: task_ids)
+        Coroutine_Resume(TASK_DONE_EVENT, task_id, time);
 }
 
 void MemoryWarning(Time_t time, MachineId_t machine_id) {
     // The simulator is alerting you that machine identified by machine_id is overcommitted
     SimOutput("MemoryWarning(): Overflow at " + to_string(machine_id) + " was detected at time " + to_string(time), 0);
+    Decisions.Record(MEMORY_RECORD, time, machine_id);
+    DeliverCompletions();
+    Scheduler.MemoryWarning(time, machine_id);
 }
 
 void MigrationDone(Time_t time, VMId_t vm_id) {
     // The function is called on to alert you that migration is complete
     SimOutput("MigrationDone(): Migration of VM " + to_string(vm_id) + " was completed at time " + to_string(time), 4);
+    Decisions.Record(MIGRATION_RECORD, time, vm_id);
+    DeliverCompletions();
     Scheduler.MigrationComplete(time, vm_id);
-    migrating = false;
+    Coroutine_Resume(MIGRATION_EVENT, vm_id, time);
 }
 
 void SchedulerCheck(Time_t time) {
     // This function is called periodically by the simulator, no specific event
     SimOutput("SchedulerCheck(): SchedulerCheck() called at " + to_string(time), 4);
+    Decisions.Checkpoint(time);
+    DeliverCompletions();
+    SchedulerTimers.Advance(time, SchedulerTimer);
     Scheduler.PeriodicCheck(time);
-    static unsigned counts = 0;
-    counts++;
-    if(counts == 10) {
-        migrating = true;
-        VM_Migrate(1, 9);
+    if(Scheduler.HasConverged()) {
+        // The simulator cannot be asked to stop early, so report and leave as it would at the end of the run
+        SimulationComplete(time);
+        exit(0);
     }
 }
 
+void SchedulerTimer(Time_t time, uint64_t cookie) {
+    // Timers are only advanced from task arrivals and the periodic check, never from inside a completion
+    SimOutput("SchedulerTimer(): Timer " + to_string(cookie) + " expired at time " + to_string(time), 4);
+    if(Coroutine_TimerExpired(time, cookie))
+        return;
+    Scheduler.TimerExpired(time, cookie);
+}
+
 void SimulationComplete(Time_t time) {
     // This function is called before the simulation terminates Add whatever you feel like.
+    DeliverCompletions();
     cout << "SLA violation report" << endl;
     cout << "SLA0: " << GetSLAReport(SLA0) << "%" << endl;
     cout << "SLA1: " << GetSLAReport(SLA1) << "%" << endl;
@@ -153,13 +509,37 @@ void SimulationComplete(Time_t time) {
     SimOutput("SimulationComplete(): Simulation finished at time " + to_string(time), 4);
     
     Scheduler.Shutdown(time);
+    Decisions.Report();
 }
 
 void SLAWarning(Time_t time, TaskId_t task_id) {
-    
+    Decisions.Record(SLA_RECORD, time, task_id);
 }
 
 void StateChangeComplete(Time_t time, MachineId_t machine_id) {
     // Called in response to an earlier request to change the state of a machine
+    SimOutput("StateChangeComplete(): Machine " + to_string(machine_id) + " changed state at time " + to_string(time), 4);
+    Decisions.Record(STATE_RECORD, time, machine_id);
+    DeliverCompletions();
+    Scheduler.MachineStateChanged(time, machine_id);
+    Coroutine_Resume(STATE_CHANGE_EVENT, machine_id, time);
+}
+
+// Scheduler timer interface below
+
+TimerId_t ScheduleSchedulerTimer(Time_t time, uint64_t cookie) {
+    SimOutput("ScheduleSchedulerTimer(): Timer " + to_string(cookie) + " requested for time " + to_string(time), 4);
+    return SchedulerTimers.Schedule(time, cookie);
+}
+
+bool CancelSchedulerTimer(TimerId_t timer_id) {
+    SimOutput("CancelSchedulerTimer(): Cancelling timer id " + to_string(timer_id), 4);
+    return SchedulerTimers.Cancel(timer_id);
 }
 
+// Scheduler placement interface below
+
+void PlaceTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    placements[task_id] = vm_id;
+    VM_AddTask(vm_id, task_id, priority);
+}
@@ -10,20 +10,62 @@
 
 #include <vector>
 
+#include "Efficiency.hpp"
+#include "Elastic.hpp"
+#include "Facility.hpp"
+#include "Federation.hpp"
+#include "Flows.hpp"
 #include "Interfaces.h"
+#include "Numa.hpp"
+#include "OmegaScheduler.hpp"
+#include "Overbooking.hpp"
+#include "RareEvent.hpp"
+#include "Realtime.hpp"
+#include "Residency.hpp"
+#include "Sampling.hpp"
+#include "Service.hpp"
+#include "Shares.hpp"
+#include "Slowdown.hpp"
+#include "SpeedScaling.hpp"
+#include "SteadyState.hpp"
+#include "TaskTemplates.hpp"
+#include "Thermal.hpp"
 
 class Scheduler {
 public:
     Scheduler()                 {}
+    bool HasConverged();
     void Init();
+    void MachineStateChanged(Time_t now, MachineId_t machine_id);
+    void MemoryWarning(Time_t now, MachineId_t machine_id);
     void MigrationComplete(Time_t time, VMId_t vm_id);
     void NewTask(Time_t now, TaskId_t task_id);
     void PeriodicCheck(Time_t now);
     void Shutdown(Time_t now);
-    void TaskComplete(Time_t now, TaskId_t task_id);
+    void TasksComplete(Time_t now, span<const TaskId_t> task_ids);
+    void TimerExpired(Time_t now, uint64_t cookie);
 private:
     vector<VMId_t> vms;
     vector<MachineId_t> machines;
+    Efficiency efficiency;
+    Elastic elastic;
+    Facility facility;
+    Federation federation;
+    Flows flows;
+    Numa numa;
+    OmegaScheduler omega;
+    Overbooking overbooking;
+    RareEvent rare;
+    Realtime realtime;
+    Residency residency;
+    Sampling sampling;
+    Service service;
+    Shares shares;
+    Slowdown slowdown;
+    SpeedScaling speed;
+    SteadyState steady;
+    TaskTemplates templates;
+    Thermal thermal;
 };
 
 
@@ -0,0 +1,209 @@
+//
+//  Service.cpp
+//  CloudSim
+//
+
+#include "Service.hpp"
+
+static const char * routing_names[] = {"round robin", "least outstanding", "power of two choices"};
+
+void Service::Init(Time_t now, const ServiceConfig_t & config) {
+    this->config = config;
+    random.seed(0);
+    if(config.min_replicas == 0)
+        ThrowException("Service::Init(): The service needs at least one replica to route requests to");
+    // The initial replicas are up when the simulation starts
+    for(unsigned i = 0; i < config.min_replicas; i++) {
+        if(!AddReplica(now, false))
+            ThrowException("Service::Init(): No machine left for replica ", i);
+    }
+}
+
+bool Service::AddReplica(Time_t now, bool boot) {
+    unsigned live = 0;
+    vector<bool> hosting(Machine_GetTotal(), false);
+    for(auto & replica: replicas) {
+        if(replica.state != REPLICA_STOPPED) {
+            live++;
+            hosting[replica.machine_id] = true;
+        }
+    }
+    if(live >= config.max_replicas)
+        return false;
+
+    // One replica per machine, on the least loaded machine that is up
+    int machine_id = -1;
+    unsigned load = 0;
+    for(unsigned i = 0; i < hosting.size(); i++) {
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+        if(hosting[i] || info.cpu != config.cpu || info.s_state != S0)
+            continue;
+        if(machine_id < 0 || info.active_tasks < load) {
+            machine_id = int(i);
+            load = info.active_tasks;
+        }
+    }
+    if(machine_id < 0)
+        return false;
+
+    VMId_t vm_id = VM_Create(config.vm_type, config.cpu);
+    VM_Attach(vm_id, MachineId_t(machine_id));
+    replicas.push_back(Replica_t{vm_id, MachineId_t(machine_id), boot ? REPLICA_BOOTING : REPLICA_READY, {}, 0, now});
+    if(boot)
+        ScheduleSchedulerTimer(now + config.boot_time, SERVICE_TIMER_FLAG | (replicas.size() - 1));
+    peak = max(peak, live + 1);
+    SimOutput("Service::AddReplica(): Replica " + to_string(replicas.size() - 1) + " on machine " + to_string(machine_id) + " at " + to_string(now), 2);
+    return true;
+}
+
+bool Service::ScaleUp(Time_t now) {
+    if(!AddReplica(now, true))
+        return false;
+    scale_ups++;
+    return true;
+}
+
+bool Service::ScaleDown(Time_t now) {
+    // The least busy ready replica stops taking requests, as long as enough stay ready
+    int victim = -1;
+    unsigned ready = 0;
+    for(unsigned i = 0; i < replicas.size(); i++) {
+        if(replicas[i].state != REPLICA_READY)
+            continue;
+        ready++;
+        if(victim < 0 || Outstanding(i) < Outstanding(unsigned(victim)))
+            victim = int(i);
+    }
+    if(ready <= config.min_replicas)
+        return false;
+
+    Replica_t & replica = replicas[victim];
+    replica.state = REPLICA_DRAINING;
+    // Its queue moves to the replicas that stay, only the running requests are left to drain
+    deque<Request_t> queue;
+    queue.swap(replica.queue);
+    for(auto & request: queue) {
+        unsigned target = unsigned(Pick());
+        replicas[target].queue.push_back(request);
+        Dispatch(target, now);
+    }
+    if(replica.running == 0)
+        Stop(unsigned(victim), now);
+    scale_downs++;
+    SimOutput("Service::ScaleDown(): Draining replica " + to_string(victim) + " at " + to_string(now), 2);
+    return true;
+}
+
+void Service::Stop(unsigned replica, Time_t now) {
+    VM_Shutdown(replicas[replica].vm_id);
+    replicas[replica].state = REPLICA_STOPPED;
+    replica_time += double(now - replicas[replica].started);
+}
+
+int Service::Pick() {
+    vector<unsigned> ready;
+    for(unsigned i = 0; i < replicas.size(); i++) {
+        if(replicas[i].state == REPLICA_READY)
+            ready.push_back(i);
+    }
+    if(ready.empty())
+        return -1;
+    switch(config.routing) {
+        case ROUND_ROBIN_ROUTING:
+            return int(ready[next_replica++ % ready.size()]);
+        case LEAST_OUTSTANDING_ROUTING: {
+            unsigned best = ready[0];
+            for(auto i: ready) {
+                if(Outstanding(i) < Outstanding(best))
+                    best = i;
+            }
+            return int(best);
+        }
+        default: {
+            unsigned first = ready[random() % ready.size()], second = ready[random() % ready.size()];
+            return int(Outstanding(second) < Outstanding(first) ? second : first);
+        }
+    }
+}
+
+bool Service::Route(Time_t now, TaskId_t task_id, Priority_t priority) {
+    if(RequiredSLA(task_id) != config.sla || RequiredVMType(task_id) != config.vm_type || RequiredCPUType(task_id) != config.cpu)
+        return false;
+    int replica = Pick();
+    if(replica < 0)
+        return false;
+    replicas[replica].queue.push_back(Request_t{task_id, priority, now});
+    Dispatch(unsigned(replica), now);
+    return true;
+}
+
+void Service::Dispatch(unsigned replica, Time_t now) {
+    Replica_t & target = replicas[replica];
+    while(target.running < config.concurrency && !target.queue.empty()) {
+        Request_t request = target.queue.front();
+        target.queue.pop_front();
+        PlaceTask(target.vm_id, request.task_id, request.priority);
+        running[request.task_id] = replica;
+        target.running++;
+        queue_wait += double(now - request.arrival);
+    }
+}
+
+void Service::TasksCompleted(Time_t now, span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        auto it = running.find(task_id);
+        if(it == running.end())
+            continue;
+        unsigned replica = it->second;
+        running.erase(it);
+        replicas[replica].running--;
+        served++;
+        Dispatch(replica, now);
+        if(replicas[replica].state == REPLICA_DRAINING && replicas[replica].running == 0)
+            Stop(replica, now);
+    }
+}
+
+void Service::TimerExpired(Time_t now, uint64_t cookie) {
+    unsigned replica = unsigned(cookie & ~SERVICE_TIMER_FLAG);
+    if(replica < replicas.size() && replicas[replica].state == REPLICA_BOOTING) {
+        replicas[replica].state = REPLICA_READY;
+        SimOutput("Service::TimerExpired(): Replica " + to_string(replica) + " ready at " + to_string(now), 2);
+    }
+}
+
+void Service::PeriodicCheck(Time_t now) {
+    // Booting replicas count as capacity already, so a burst does not add a replica on every check
+    unsigned outstanding = 0, capacity = 0;
+    for(unsigned i = 0; i < replicas.size(); i++) {
+        if(replicas[i].state == REPLICA_READY || replicas[i].state == REPLICA_BOOTING) {
+            outstanding += Outstanding(i);
+            capacity++;
+        }
+    }
+    if(!capacity)
+        return;
+    double per_replica = double(outstanding) / capacity;
+    if(per_replica > config.scale_up)
+        ScaleUp(now);
+    else if(per_replica < config.scale_down)
+        ScaleDown(now);
+}
+
+void Service::Report(Time_t now) {
+    double lifetime = replica_time;
+    for(auto & replica: replicas) {
+        if(replica.state != REPLICA_STOPPED)
+            lifetime += double(now - replica.started);
+    }
+    cout << "Service: " << served << " requests served by up to " << peak << " replicas (" << scale_ups << " scale ups, "
+         << scale_downs << " scale downs), " << routing_names[config.routing] << " routing" << endl;
+    cout << "Service mean queue wait: " << (served ? queue_wait / served : 0) << "us, replica time " << lifetime / 1000000 << "s" << endl;
+}
+
+void Service::Shutdown() {
+    for(auto & replica: replicas) {
+        if(replica.state != REPLICA_STOPPED)
+            VM_Shutdown(replica.vm_id);
+    }
+}
@@ -0,0 +1,100 @@
+//
+//  Service.hpp
+//  CloudSim
+//
+//  Web tier modeled as a service: a replica set of long running VMs, each
+//  with its own request queue. Requests are routed to a replica by round
+//  robin, least outstanding or power of two choices, and each replica runs
+//  at most a fixed number of them at once; the rest wait in its queue.
+//  Replicas are added and removed through ScaleUp and ScaleDown, which the
+//  periodic check drives from the outstanding requests per replica. A new
+//  replica only takes requests once its boot time has elapsed, and a
+//  removed one drains its queue before its VM is shut down.
+//
+
+#ifndef Service_hpp
+#define Service_hpp
+
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "Interfaces.h"
+
+#define SERVICE_TIMER_FLAG      (uint64_t(1) << 62) // Marks the timer cookies of replicas that finish booting
+
+typedef enum {
+    ROUND_ROBIN_ROUTING,
+    LEAST_OUTSTANDING_ROUTING,
+    POWER_OF_TWO_ROUTING
+} Routing_t;
+
+typedef enum {
+    REPLICA_BOOTING,
+    REPLICA_READY,
+    REPLICA_DRAINING,
+    REPLICA_STOPPED
+} ReplicaState_t;
+
+typedef struct {
+    TaskId_t task_id;
+    Priority_t priority;
+    Time_t arrival;
+} Request_t;
+
+typedef struct {
+    VMId_t vm_id;
+    MachineId_t machine_id;
+    ReplicaState_t state;
+    deque<Request_t> queue;                 // Requests routed to the replica but not running yet
+    unsigned running;
+    Time_t started;                         // Time the replica was requested
+} Replica_t;
+
+typedef struct {
+    VMType_t vm_type;
+    CPUType_t cpu;
+    SLAType_t sla;                          // Requests of this SLA are served by the replicas
+    Routing_t routing;
+    unsigned min_replicas;
+    unsigned max_replicas;
+    unsigned concurrency;                   // Requests running at once on a replica
+    Time_t boot_time;
+    double scale_up;                        // Outstanding requests per ready replica that add one
+    double scale_down;                      // Outstanding requests per ready replica that remove one
+} ServiceConfig_t;
+
+class Service {
+public:
+    Service()                   {}
+    void Init(Time_t now, const ServiceConfig_t & config);
+    void PeriodicCheck(Time_t now);
+    void Report(Time_t now);
+    bool Route(Time_t now, TaskId_t task_id, Priority_t priority);
+    bool ScaleDown(Time_t now);
+    bool ScaleUp(Time_t now);
+    void Shutdown();
+    void TasksCompleted(Time_t now, span<const TaskId_t> task_ids);
+    void TimerExpired(Time_t now, uint64_t cookie);
+private:
+    bool     AddReplica(Time_t now, bool boot);
+    void     Dispatch(unsigned replica, Time_t now);
+    int      Pick();
+    void     Stop(unsigned replica, Time_t now);
+    unsigned Outstanding(unsigned replica)  { return unsigned(replicas[replica].queue.size()) + replicas[replica].running; }
+
+    ServiceConfig_t config;
+    vector<Replica_t> replicas;
+    map<TaskId_t, unsigned> running;        // Replica of every request handed to a VM
+    unsigned next_replica = 0;              // Round robin position
+    mt19937_64 random;
+    uint64_t served = 0;
+    double queue_wait = 0;                  // Total time requests spent in a replica queue
+    uint64_t scale_ups = 0;
+    uint64_t scale_downs = 0;
+    unsigned peak = 0;
+    double replica_time = 0;                // Replica lifetime, booting and draining included
+};
+
+#endif /* Service_hpp */
@@ -0,0 +1,210 @@
+//
+//  Shares.cpp
+//  CloudSim
+//
+
+#include "Shares.hpp"
+
+static void CheckConfig(const ShareConfig_t & config, string what) {
+    if(config.shares <= 0)
+        ThrowException("Shares: Shares must be positive, ", what);
+    if(config.cap <= 0 || config.cap > 1)
+        ThrowException("Shares: A cap is a fraction of the cores in (0, 1], ", what);
+}
+
+void Shares::Init(string path) {
+    vector<InputBlock_t> blocks = ReadInputBlocks(path);
+    classes = ReadTaskClasses(blocks);
+    defaults.assign(classes.size() + 1, ShareConfig_t{1, 1});
+    for(auto & block: blocks) {
+        if(block.type != "vm share")
+            continue;
+        unsigned task_class = unsigned(stoul(block.fields["Task class"]));
+        if(task_class >= classes.size())
+            ThrowException("Shares::Init(): No task class ", task_class);
+        if(block.fields.count("Shares"))
+            defaults[task_class].shares = stod(block.fields["Shares"]);
+        if(block.fields.count("Cap"))
+            defaults[task_class].cap = stod(block.fields["Cap"]);
+        CheckConfig(defaults[task_class], "task class " + to_string(task_class));
+    }
+    for(unsigned i = 0; i < Machine_GetTotal(); i++) {
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+        machines.push_back(ShareMachine_t{info.cpu, info.num_cpus, 0, 0, {}, {}, 0});
+    }
+}
+
+void Shares::SetShares(VMId_t vm_id, double shares) {
+    Tenant_t & tenant = tenants.at(vm_id);
+    CheckConfig(ShareConfig_t{shares, tenant.config.cap}, "VM " + to_string(vm_id));
+    tenant.config.shares = shares;
+}
+
+void Shares::SetCap(VMId_t vm_id, double cap) {
+    Tenant_t & tenant = tenants.at(vm_id);
+    CheckConfig(ShareConfig_t{tenant.config.shares, cap}, "VM " + to_string(vm_id));
+    tenant.config.cap = cap;
+    Update(vm_id, tenant);
+    Fill(Now(), tenant.machine_id);
+}
+
+unsigned Shares::Limit(const Tenant_t & tenant) {
+    return max(1u, unsigned(tenant.config.cap * machines[tenant.machine_id].num_cpus));
+}
+
+void Shares::Update(VMId_t vm_id, Tenant_t & tenant) {
+    // A VM is in the ready set while it has queued tasks and is below its cap, so the pick never skips one
+    ShareMachine_t & machine = machines[tenant.machine_id];
+    if(tenant.ready)
+        machine.ready.erase({tenant.pass, vm_id});
+    tenant.ready = !tenant.queue.empty() && tenant.running < Limit(tenant);
+    if(tenant.ready)
+        machine.ready.insert({tenant.pass, vm_id});
+}
+
+VMId_t Shares::VMFor(MachineId_t machine_id, unsigned task_class, VMType_t vm_type) {
+    ShareMachine_t & machine = machines[machine_id];
+    auto it = machine.vms.find({task_class, vm_type});
+    if(it != machine.vms.end())
+        return it->second;
+    VMId_t vm_id = VM_Create(vm_type, machine.cpu);
+    VM_Attach(vm_id, machine_id);
+    machine.vms[{task_class, vm_type}] = vm_id;
+    tenants[vm_id] = Tenant_t{task_class, machine_id, defaults[task_class], machine.global_pass, false, 0, {}, 0, 0, 0, 0};
+    return vm_id;
+}
+
+void Shares::Start(Time_t now, VMId_t vm_id, const ShareRequest_t & request) {
+    Tenant_t & tenant = tenants[vm_id];
+    ShareMachine_t & machine = machines[tenant.machine_id];
+    if(tenant.ready) {
+        machine.ready.erase({tenant.pass, vm_id});
+        tenant.ready = false;
+    }
+    PlaceTask(vm_id, request.task_id, request.priority);
+    machine.running++;
+    tenant.running++;
+    running[request.task_id] = ShareTask_t{vm_id, now};
+    tenant.wait += double(now - request.arrival);
+    machine.global_pass = max(machine.global_pass, tenant.pass);
+    // Charging the instructions of the task keeps the core time, not the task count, in proportion to the shares
+    tenant.pass += double(GetTaskInfo(request.task_id).total_instructions) / tenant.config.shares;
+    Update(vm_id, tenant);
+}
+
+void Shares::Fill(Time_t now, MachineId_t machine_id) {
+    // Give every free core to the ready VM with the lowest pass
+    ShareMachine_t & machine = machines[machine_id];
+    if(Machine_GetInfo(machine_id).s_state != S0)
+        return;
+    while(machine.running < machine.num_cpus && !machine.ready.empty()) {
+        VMId_t vm_id = machine.ready.begin()->second;
+        Tenant_t & tenant = tenants[vm_id];
+        ShareRequest_t request = tenant.queue.front();
+        tenant.queue.pop_front();
+        machine.queued--;
+        Start(now, vm_id, request);
+    }
+}
+
+void Shares::NewTask(Time_t now, TaskId_t task_id, Priority_t priority) {
+    int spec = MatchTaskClass(classes, now, task_id);
+    unsigned task_class = spec < 0 ? unsigned(classes.size()) : unsigned(spec);
+    CPUType_t cpu = RequiredCPUType(task_id);
+    VMType_t vm_type = RequiredVMType(task_id);
+    // The least loaded machine with a free core where the VM of the class may start it now, otherwise the
+    // machine with the fewest tasks per core counting the queued ones. Nothing overtakes a queued task of its VM
+    int best = -1, fallback = -1;
+    double best_load = 0, fallback_load = 0;
+    for(unsigned i = 0; i < machines.size(); i++) {
+        ShareMachine_t & machine = machines[i];
+        if(machine.cpu != cpu || Machine_GetInfo(MachineId_t(i)).s_state != S0)
+            continue;
+        double load = double(machine.running) / machine.num_cpus;
+        double backlog = double(machine.running + machine.queued) / machine.num_cpus;
+        auto vm = machine.vms.find({task_class, vm_type});
+        bool startable = machine.running < machine.num_cpus;
+        if(vm != machine.vms.end()) {
+            Tenant_t & tenant = tenants[vm->second];
+            startable = startable && tenant.queue.empty() && tenant.running < Limit(tenant);
+        }
+        if(startable && (best < 0 || load < best_load)) {
+            best = int(i);
+            best_load = load;
+        }
+        if(fallback < 0 || backlog < fallback_load) {
+            fallback = int(i);
+            fallback_load = backlog;
+        }
+    }
+    if(fallback < 0)
+        ThrowException("Shares::NewTask(): No machine for task ", task_id);
+
+    MachineId_t machine_id = MachineId_t(best >= 0 ? best : fallback);
+    VMId_t vm_id = VMFor(machine_id, task_class, vm_type);
+    Tenant_t & tenant = tenants[vm_id];
+    tenant.tasks++;
+    ShareRequest_t request = {task_id, priority, now};
+    if(best >= 0) {
+        Start(now, vm_id, request);
+        return;
+    }
+    // A VM that was idle gets no credit for the time it did not ask for cores
+    if(tenant.queue.empty() && !tenant.ready)
+        tenant.pass = max(tenant.pass, machines[machine_id].global_pass);
+    tenant.queue.push_back(request);
+    tenant.queued++;
+    machines[machine_id].queued++;
+    Update(vm_id, tenant);
+}
+
+void Shares::TasksCompleted(Time_t now, span<const TaskId_t> task_ids) {
+    set<MachineId_t> freed;
+    for(auto task_id: task_ids) {
+        auto it = running.find(task_id);
+        if(it == running.end())
+            continue;
+        VMId_t vm_id = it->second.vm_id;
+        Tenant_t & tenant = tenants[vm_id];
+        // A task holds a core of its own for all of its run, which ended before the batch was delivered
+        tenant.usage += double(GetTaskInfo(task_id).completion - it->second.start);
+        tenant.running--;
+        machines[tenant.machine_id].running--;
+        Update(vm_id, tenant);
+        freed.insert(tenant.machine_id);
+        running.erase(it);
+    }
+    for(auto machine_id: freed)
+        Fill(now, machine_id);
+}
+
+void Shares::Report() {
+    vector<Tenant_t> totals(defaults.size(), Tenant_t{0, 0, {0, 0}, 0, false, 0, {}, 0, 0, 0, 0});
+    vector<unsigned> vms(defaults.size(), 0);
+    double total = 0;
+    for(auto & [vm_id, tenant]: tenants) {
+        Tenant_t & sum = totals[tenant.task_class];
+        vms[tenant.task_class]++;
+        sum.tasks += tenant.tasks;
+        sum.queued += tenant.queued;
+        sum.wait += tenant.wait;
+        sum.usage += tenant.usage;
+        total += tenant.usage;
+        SimOutput("Shares::Report(): VM " + to_string(vm_id) + " on machine " + to_string(tenant.machine_id) + " shares " + to_string(tenant.config.shares)
+                  + " cap " + to_string(tenant.config.cap) + " used " + to_string(tenant.usage / 1000000) + " core-s", 1);
+    }
+    for(unsigned i = 0; i < totals.size(); i++) {
+        Tenant_t & sum = totals[i];
+        if(!sum.tasks)
+            continue;
+        cout << "Shares: " << (i < classes.size() ? "task class " + to_string(i) : string("unclassified")) << " shares " << defaults[i].shares
+             << " cap " << defaults[i].cap << ", " << vms[i] << " VMs, " << sum.tasks << " tasks, " << sum.usage / 1000000 << " core-s ("
+             << (total ? 100 * sum.usage / total : 0) << "%), " << sum.queued << " queued (mean wait "
+             << (sum.queued ? sum.wait / sum.queued / 1000 : 0) << "ms)" << endl;
+    }
+}
+
+void Shares::Shutdown() {
+    for(auto & [vm_id, tenant]: tenants)
+        VM_Shutdown(vm_id);
+}
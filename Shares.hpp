@@ -0,0 +1,97 @@
+//
+//  Shares.hpp
+//  CloudSim
+//
+//  Per-VM CPU shares and caps. Every VM is a tenant with shares and a cap
+//  of its own, which the scheduler can set. The tasks of a task class run
+//  in a VM of that class on each machine they use, and a "vm share:" block
+//  gives the shares and cap those VMs start with. A machine runs at most
+//  one task per core, so tasks of different VMs never time-slice against
+//  each other. When cores are short, the VMs of a machine with waiting
+//  tasks are served by stride scheduling: at every dispatch a VM's pass
+//  advances by the instructions of the task over its shares, and a freed
+//  core goes to the VM with the lowest pass. Only VMs with queued tasks
+//  that are below their cap sit in the ordered set of passes, so the pick
+//  is O(log n). A cap bounds the fraction of the machine's cores the VM can
+//  hold. Holding a whole core per task is not work conserving: a task that
+//  would leave part of its core idle still keeps it, and the queued tasks
+//  of a capped VM wait even while other machines have free cores. Core
+//  time is accounted per VM and summed per task class.
+//
+
+#ifndef Shares_hpp
+#define Shares_hpp
+
+#include <deque>
+#include <map>
+#include <set>
+#include <span>
+#include <vector>
+
+#include "InputBlocks.hpp"
+
+typedef struct {
+    TaskId_t task_id;
+    Priority_t priority;
+    Time_t arrival;
+} ShareRequest_t;
+
+typedef struct {
+    double shares;
+    double cap;                             // Fraction of the machine's cores the VM may hold, 1 for no cap
+} ShareConfig_t;
+
+typedef struct {
+    unsigned task_class;                    // Class of its tasks, classes.size() for tasks that match none
+    MachineId_t machine_id;
+    ShareConfig_t config;
+    double pass;                            // Stride scheduling position
+    bool ready;                             // In the ready set of its machine
+    unsigned running;
+    deque<ShareRequest_t> queue;
+    uint64_t tasks;
+    uint64_t queued;
+    double wait;                            // Time spent queued, summed over the tasks, in microseconds
+    double usage;                           // Core time of the completed tasks, in microseconds
+} Tenant_t;
+
+typedef struct {
+    CPUType_t cpu;
+    unsigned num_cpus;
+    unsigned running;
+    unsigned queued;
+    map<pair<unsigned, VMType_t>, VMId_t> vms;   // VM of every task class and VM type
+    set<pair<double, VMId_t> > ready;       // Pass of every VM with queued tasks below its cap
+    double global_pass;                     // Highest pass dispatched so far, where a VM that was idle rejoins
+} ShareMachine_t;
+
+typedef struct {
+    VMId_t vm_id;
+    Time_t start;
+} ShareTask_t;
+
+class Shares {
+public:
+    Shares()                    {}
+    void Init(string path);
+    void NewTask(Time_t now, TaskId_t task_id, Priority_t priority);
+    void Report();
+    void SetCap(VMId_t vm_id, double cap);
+    void SetShares(VMId_t vm_id, double shares);
+    void Shutdown();
+    void TasksCompleted(Time_t now, span<const TaskId_t> task_ids);
+private:
+    void     Fill(Time_t now, MachineId_t machine_id);
+    unsigned Limit(const Tenant_t & tenant);
+    void     Start(Time_t now, VMId_t vm_id, const ShareRequest_t & request);
+    void     Update(VMId_t vm_id, Tenant_t & tenant);
+    VMId_t   VMFor(MachineId_t machine_id, unsigned task_class, VMType_t vm_type);
+
+    vector<TaskClassSpec_t> classes;
+    vector<ShareConfig_t> defaults;         // Per task class, the last for tasks that match none
+    vector<ShareMachine_t> machines;
+    map<VMId_t, Tenant_t> tenants;
+    map<TaskId_t, ShareTask_t> running;
+};
+
+#endif /* Shares_hpp */
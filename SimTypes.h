@@ -15,6 +15,7 @@ using namespace std;
 
 typedef uint64_t Time_t;          // Time is computed in microseconds
 typedef uint64_t EventId_t;
+typedef uint64_t TimerId_t;
 
 typedef unsigned CPUId_t;
 typedef unsigned MachineId_t;
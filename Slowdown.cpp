@@ -0,0 +1,60 @@
+//
+//  Slowdown.cpp
+//  CloudSim
+//
+
+#include "Internal_Interfaces.h"
+#include "Slowdown.hpp"
+
+static const Time_t SLICE = 60000;          // Period of the machine timer that rotates the running tasks
+
+void Slowdown::Set(TaskId_t task_id, SlowdownSource_t source, double factor) {
+    if(factor <= 0)
+        ThrowException("Slowdown::Set(): Factor must be positive for task ", task_id);
+    auto it = tasks.find(task_id);
+    if(it == tasks.end()) {
+        SlowdownTask_t task;
+        for(auto & other: task.factors)
+            other = 1;
+        task.applied = 1;
+        it = tasks.insert({task_id, task}).first;
+    }
+    it->second.factors[source] = factor;
+}
+
+double Slowdown::Unscaled(TaskId_t task_id) {
+    if(IsTaskCompleted(task_id))
+        return 0;
+    auto it = tasks.find(task_id);
+    return double(GetRemainingInstructions(task_id)) / (it == tasks.end() ? 1 : it->second.applied);
+}
+
+void Slowdown::Apply(TaskId_t task_id, MachineId_t machine_id, bool running) {
+    // The machine is only read for a running task, a task that is not added yet can be set either way
+    auto it = tasks.find(task_id);
+    if(it == tasks.end() || IsTaskCompleted(task_id))
+        return;
+    SlowdownTask_t & task = it->second;
+    double product = 1;
+    for(auto factor: task.factors)
+        product *= factor;
+    if(product == task.applied)
+        return;
+    uint64_t remaining = GetRemainingInstructions(task_id);
+    uint64_t scaled = max<uint64_t>(1, uint64_t(double(remaining) * product / task.applied));
+    if(running && scaled < remaining) {
+        // The next rotation takes off up to a slice at P0, and a completion already projected still fires
+        uint64_t floor = uint64_t(Machine_GetInfo(machine_id).performance[P0]) * SLICE * 2;
+        if(remaining <= floor)
+            return;
+        scaled = max(scaled, floor);
+        product = task.applied * double(scaled) / double(remaining);
+    }
+    SetRemainingInstructions(task_id, scaled);
+    task.applied = product;
+}
+
+void Slowdown::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids)
+        tasks.erase(task_id);
+}
@@ -0,0 +1,49 @@
+//
+//  Slowdown.hpp
+//  CloudSim
+//
+//  Ledger of the factors the models apply to the instructions of a task.
+//  The simulator turns instructions into time at the MIPS of the P-state,
+//  so a model that slows a task down or speeds it up does so by scaling
+//  its remaining instructions. Every model sets its own factor here, and
+//  the ledger rewrites the instructions once with the product of all of
+//  them, starting from the unscaled remainder: the remaining instructions
+//  over the product last applied. A model that changes or drops its factor
+//  therefore leaves the factors of the others in place. The simulator takes
+//  the instructions a core executed in a slice off the count when it
+//  rotates the running tasks, so a running task is lowered no further than
+//  two slices of work at P0, and the rest waits for a later Apply.
+//
+
+#ifndef Slowdown_hpp
+#define Slowdown_hpp
+
+#include <map>
+#include <span>
+
+#include "Interfaces.h"
+
+typedef enum {
+    EFFICIENCY_SLOWDOWN,                    // Throughput and frequency sensitivity of the task class
+    NUMA_SLOWDOWN,                          // Memory on remote NUMA nodes
+    TURBO_SLOWDOWN,                         // Thermal turbo headroom, below one
+    SLOWDOWN_SOURCES
+} SlowdownSource_t;
+
+typedef struct {
+    double factors[SLOWDOWN_SOURCES];
+    double applied;                         // Product of the factors the instructions hold now
+} SlowdownTask_t;
+
+class Slowdown {
+public:
+    Slowdown()                  {}
+    void   Apply(TaskId_t task_id, MachineId_t machine_id, bool running);
+    void   Set(TaskId_t task_id, SlowdownSource_t source, double factor);
+    void   TasksCompleted(span<const TaskId_t> task_ids);
+    double Unscaled(TaskId_t task_id);
+private:
+    map<TaskId_t, SlowdownTask_t> tasks;
+};
+
+#endif /* Slowdown_hpp */
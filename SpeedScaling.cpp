@@ -0,0 +1,120 @@
+//
+//  SpeedScaling.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+
+#include "SpeedScaling.hpp"
+
+CPUPerformance_t SpeedScaling::RequiredPState(MachineId_t machine_id, Time_t now) {
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    vector<pair<Time_t, uint64_t> > jobs;
+    for(auto task_id: machines[machine_id].tasks) {
+        TaskInfo_t task = GetTaskInfo(task_id);
+        if(task.completed)
+            continue;
+        if(task.target_completion <= now)
+            return P0;                      // Already late, run as fast as possible
+        jobs.push_back({task.target_completion, task.remaining_instructions});
+    }
+    sort(jobs.begin(), jobs.end());
+
+    // Critical intensity in instructions per microsecond, which is MIPS. Every prefix of the
+    // deadline order must fit on all the cores. The machine time-slices its cores round robin
+    // rather than running EDF, so a task only gets num_cpus / tasks of a core, and never more than one
+    double required = 0;
+    double work = 0;
+    double share = min(1.0, double(info.num_cpus) / max<size_t>(jobs.size(), 1));
+    for(auto & job: jobs) {
+        double window = double(job.first - now);
+        work += double(job.second);
+        required = max(required, double(job.second) / (window * share));
+        required = max(required, work / (window * info.num_cpus));
+    }
+    for(int p = P_STATES - 1; p > P0; p--)
+        if(info.performance[p] >= required)
+            return CPUPerformance_t(p);
+    return P0;
+}
+
+void SpeedScaling::Account(MachineId_t machine_id, Time_t now) {
+    SpeedMachine_t & machine = machines[machine_id];
+    MachineInfo_t info = Machine_GetInfo(machine_id);
+    unsigned busy = min(info.active_tasks, info.num_cpus);
+    // Same instructions at P0 would have cost p_states[P0] for a shorter time
+    double p0_power = double(info.p_states[P0]) * info.performance[machine.p_state] / info.performance[P0];
+    machine.saved += busy * (p0_power - info.p_states[machine.p_state]) * double(now - machine.last_update) / 1000000;
+    machine.last_update = now;
+}
+
+void SpeedScaling::Recompute(MachineId_t machine_id, Time_t now) {
+    SpeedMachine_t & machine = machines[machine_id];
+    Account(machine_id, now);
+    CPUPerformance_t p_state = RequiredPState(machine_id, now);
+    if(p_state == machine.p_state)
+        return;
+    unsigned num_cpus = Machine_GetInfo(machine_id).num_cpus;
+    for(unsigned core = 0; core < num_cpus; core++)
+        Machine_SetCorePerformance(machine_id, core, p_state);
+    machine.p_state = p_state;
+    SimOutput("SpeedScaling::Recompute(): Machine " + to_string(machine_id) + " moved to P" + to_string(p_state) + " at " + to_string(now), 3);
+}
+
+void SpeedScaling::TaskArrived(Time_t now, TaskId_t task_id, MachineId_t machine_id) {
+    if(machines.find(machine_id) == machines.end())
+        machines[machine_id] = SpeedMachine_t{{}, Machine_GetInfo(machine_id).p_state, now, 0};
+    machines[machine_id].tasks.insert(task_id);
+    task_machine[task_id] = machine_id;
+    Recompute(machine_id, now);
+}
+
+void SpeedScaling::TasksCompleted(Time_t now, span<const TaskId_t> task_ids) {
+    // Every machine that lost tasks is recomputed once for the whole batch
+    set<MachineId_t> changed;
+    for(auto task_id: task_ids) {
+        auto it = task_machine.find(task_id);
+        if(it == task_machine.end())
+            continue;
+        changed.insert(it->second);
+        machines[it->second].tasks.erase(task_id);
+        task_machine.erase(it);
+    }
+    for(auto machine_id: changed)
+        Recompute(machine_id, now);
+}
+
+void SpeedScaling::MigrationComplete(Time_t now, VMId_t vm_id) {
+    VMInfo_t info = VM_GetInfo(vm_id);
+    set<MachineId_t> changed = {info.machine_id};
+    for(auto task_id: info.active_tasks) {
+        auto it = task_machine.find(task_id);
+        if(it == task_machine.end() || it->second == info.machine_id)
+            continue;
+        changed.insert(it->second);
+        machines[it->second].tasks.erase(task_id);
+        it->second = info.machine_id;
+    }
+    if(machines.find(info.machine_id) == machines.end())
+        machines[info.machine_id] = SpeedMachine_t{{}, Machine_GetInfo(info.machine_id).p_state, now, 0};
+    for(auto task_id: info.active_tasks)
+        if(task_machine.count(task_id))
+            machines[info.machine_id].tasks.insert(task_id);
+    for(auto machine_id: changed)
+        Recompute(machine_id, now);
+}
+
+void SpeedScaling::PeriodicCheck(Time_t now) {
+    // Critical intervals end as tasks progress, so the speed can come down between events
+    for(auto & machine: machines)
+        Recompute(machine.first, now);
+}
+
+void SpeedScaling::Report(Time_t now) {
+    double saved = 0;
+    for(auto & machine: machines) {
+        Account(machine.first, now);
+        saved += machine.second.saved;
+    }
+    cout << "DVFS dynamic energy saved against P0: " << saved / 3600000 << "KW-Hour" << endl;
+}
@@ -0,0 +1,46 @@
+//
+//  SpeedScaling.hpp
+//  CloudSim
+//
+//  Deadline-aware DVFS. For every machine, picks the slowest P-state that
+//  still finishes each resident task by its target_completion, using the
+//  YDS critical intensity over the tasks ordered by deadline, bounded by the
+//  round robin share each task gets of a core. The speed is recomputed when
+//  a task arrives or completes and on every periodic check, which follows
+//  the YDS schedule down as critical intervals finish.
+//
+
+#ifndef SpeedScaling_hpp
+#define SpeedScaling_hpp
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    set<TaskId_t> tasks;                    // Tasks resident on the machine
+    CPUPerformance_t p_state;               // P-state last applied by the module
+    Time_t last_update;                     // Time up to which the energy saving is accounted
+    double saved;                           // Dynamic energy saved against P0, in joules
+} SpeedMachine_t;
+
+class SpeedScaling {
+public:
+    SpeedScaling()              {}
+    void             MigrationComplete(Time_t now, VMId_t vm_id);
+    void             PeriodicCheck(Time_t now);
+    void             Report(Time_t now);
+    CPUPerformance_t RequiredPState(MachineId_t machine_id, Time_t now);
+    void             TaskArrived(Time_t now, TaskId_t task_id, MachineId_t machine_id);
+    void             TasksCompleted(Time_t now, span<const TaskId_t> task_ids);
+private:
+    void Account(MachineId_t machine_id, Time_t now);
+    void Recompute(MachineId_t machine_id, Time_t now);
+
+    map<MachineId_t, SpeedMachine_t> machines;
+    map<TaskId_t, MachineId_t> task_machine;
+};
+
+#endif /* SpeedScaling_hpp */
@@ -0,0 +1,105 @@
+//
+//  SteadyState.cpp
+//  CloudSim
+//
+
+#include <cmath>
+
+#include "SteadyState.hpp"
+
+#define MSER_BATCH      5                   // Intervals per MSER batch
+#define CI_BATCHES      10                  // Batch means used for the confidence interval
+#define T_QUANTILE      2.262               // Student t at 97.5% with CI_BATCHES - 1 degrees of freedom
+#define RATE_FLOOR      0.001               // Absolute precision accepted for rates close to zero
+
+void SteadyState::Init(Time_t now, double precision) {
+    this->precision = precision;
+    interval_start = now;
+    interval_energy = Machine_GetClusterEnergy();
+    power_estimate = sla_estimate = SteadyEstimate_t{0, 0, 0, false};
+}
+
+void SteadyState::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto task_id: task_ids) {
+        if(RequiredSLA(task_id) == SLA3)
+            continue;                       // Best effort tasks cannot violate their SLA
+        batch_completed++;
+        if(IsSLAViolation(task_id))
+            batch_violations++;
+    }
+}
+
+void SteadyState::PeriodicCheck(Time_t now) {
+    double energy = Machine_GetClusterEnergy();
+    if(now > interval_start)
+        batch_power += (energy - interval_energy) * 3600000 / (double(now - interval_start) / 1000000);
+    interval_start = now;
+    interval_energy = energy;
+    if(++intervals % MSER_BATCH != 0)
+        return;
+
+    power.push_back(batch_power / MSER_BATCH);
+    batch_end.push_back(now);
+    if(batch_completed)
+        sla.push_back(double(batch_violations) / batch_completed);
+    batch_power = 0;
+    batch_completed = batch_violations = 0;
+
+    power_estimate = Estimate(power);
+    sla_estimate = Estimate(sla);
+    converged = power_estimate.valid && sla_estimate.valid
+        && power_estimate.half_width <= precision * fabs(power_estimate.mean)
+        && sla_estimate.half_width <= max(precision * sla_estimate.mean, RATE_FLOOR);
+}
+
+SteadyEstimate_t SteadyState::Estimate(const vector<double> & batches) {
+    unsigned count = unsigned(batches.size());
+    if(count < 2 * CI_BATCHES)
+        return SteadyEstimate_t{0, 0, 0, false};
+
+    // MSER-5: truncate the warm-up d that minimizes the variance of the remaining mean, d <= count / 2
+    vector<double> sum(count + 1, 0), squares(count + 1, 0);
+    for(unsigned i = count; i > 0; i--) {
+        sum[i - 1] = sum[i] + batches[i - 1];
+        squares[i - 1] = squares[i] + batches[i - 1] * batches[i - 1];
+    }
+    unsigned truncated = 0;
+    double best = -1;
+    for(unsigned d = 0; d <= count / 2; d++) {
+        double n = count - d;
+        double mser = (squares[d] - sum[d] * sum[d] / n) / (n * n);
+        if(best < 0 || mser < best) {
+            best = mser;
+            truncated = d;
+        }
+    }
+
+    // Merge what is left into CI_BATCHES batch means, dropping the oldest remainder
+    unsigned size = (count - truncated) / CI_BATCHES;
+    if(size == 0)
+        return SteadyEstimate_t{0, 0, truncated, false};
+    unsigned first = count - size * CI_BATCHES;
+    vector<double> means(CI_BATCHES, 0);
+    double mean = 0;
+    for(unsigned i = 0; i < CI_BATCHES; i++) {
+        for(unsigned j = 0; j < size; j++)
+            means[i] += batches[first + i * size + j];
+        means[i] /= size;
+        mean += means[i] / CI_BATCHES;
+    }
+    double variance = 0;
+    for(auto value: means)
+        variance += (value - mean) * (value - mean) / (CI_BATCHES - 1);
+    return SteadyEstimate_t{mean, T_QUANTILE * sqrt(variance / CI_BATCHES), truncated, true};
+}
+
+void SteadyState::Report() {
+    if(!power_estimate.valid || !sla_estimate.valid) {
+        cout << "Steady state: not enough data for an estimate (" << power.size() << " batches)" << endl;
+        return;
+    }
+    Time_t warm_up = power_estimate.truncated ? batch_end[power_estimate.truncated - 1] : 0;
+    cout << "Steady state" << (converged ? "" : " (target precision not reached)") << ": warm-up " << double(warm_up) / 1000000 << " seconds" << endl;
+    cout << "Steady state power: " << power_estimate.mean << "W +/- " << power_estimate.half_width << "W (95%)" << endl;
+    cout << "Steady state SLA violation rate: " << 100 * sla_estimate.mean << "% +/- " << 100 * sla_estimate.half_width << "% (95%)" << endl;
+}
@@ -0,0 +1,54 @@
+//
+//  SteadyState.hpp
+//  CloudSim
+//
+//  Online convergence detection for the cluster power and the SLA violation
+//  rate. Every periodic check closes an interval. Intervals are grouped in
+//  batches of five, MSER-5 picks the warm-up to truncate, and the remaining
+//  batches are merged into a fixed number of batch means that give a 95%
+//  confidence interval. The run has converged once both half-widths are
+//  within the target relative precision.
+//
+
+#ifndef SteadyState_hpp
+#define SteadyState_hpp
+
+#include <span>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    double mean;
+    double half_width;                      // Half-width of the 95% confidence interval
+    unsigned truncated;                     // Batches discarded as warm-up
+    bool valid;                             // False until there are enough batches
+} SteadyEstimate_t;
+
+class SteadyState {
+public:
+    SteadyState()               {}
+    bool HasConverged()         { return converged; }
+    void Init(Time_t now, double precision);
+    void PeriodicCheck(Time_t now);
+    void Report();
+    void TasksCompleted(span<const TaskId_t> task_ids);
+private:
+    SteadyEstimate_t Estimate(const vector<double> & batches);
+
+    double precision;
+    Time_t interval_start;
+    double interval_energy;                 // Cluster energy at interval_start
+    unsigned intervals = 0;
+    double batch_power = 0;                 // Sums over the batch being filled
+    unsigned batch_completed = 0;
+    unsigned batch_violations = 0;
+    vector<double> power;                   // Per-batch average power
+    vector<double> sla;                     // Per-batch SLA violation rate, batches without completions are skipped
+    vector<Time_t> batch_end;               // End time of every power batch
+    SteadyEstimate_t power_estimate;
+    SteadyEstimate_t sla_estimate;
+    bool converged = false;
+};
+
+#endif /* SteadyState_hpp */
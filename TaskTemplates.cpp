@@ -0,0 +1,46 @@
+//
+//  TaskTemplates.cpp
+//  CloudSim
+//
+
+#include <cmath>
+
+#include "TaskTemplates.hpp"
+
+#define PERIODIC_JITTER 0.5                 // Largest jitter, relative to the period, of a periodic template
+
+TaskInstance_t TaskTemplates::Instance(Time_t now, TaskId_t task_id) {
+    TaskInfo_t info = GetTaskInfo(task_id);
+    auto key = make_tuple(info.required_vm, info.required_cpu, info.required_sla, info.required_memory, info.gpu_capable);
+    auto it = index.find(key);
+    if(it == index.end()) {
+        it = index.insert({key, unsigned(templates.size())}).first;
+        templates.push_back(TaskTemplate_t{info.required_vm, info.required_cpu, info.required_sla, info.required_memory, info.gpu_capable, 0, now, 0, 0});
+    }
+    TaskTemplate_t & shape = templates[it->second];
+    if(shape.instances) {
+        // Running mean and spread of the time between arrivals (Welford)
+        double gap = double(now - shape.last_arrival);
+        double delta = gap - shape.period;
+        shape.period += delta / shape.instances;
+        shape.spread += delta * (gap - shape.period);
+    }
+    shape.instances++;
+    shape.last_arrival = now;
+    return TaskInstance_t{task_id, it->second, now};
+}
+
+void TaskTemplates::Report() {
+    uint64_t instances = 0;
+    unsigned periodic = 0;
+    for(unsigned i = 0; i < templates.size(); i++) {
+        TaskTemplate_t & shape = templates[i];
+        double jitter = shape.instances > 2 ? sqrt(shape.spread / (shape.instances - 2)) : 0;
+        bool is_periodic = shape.instances > 2 && jitter <= PERIODIC_JITTER * shape.period;
+        instances += shape.instances;
+        periodic += is_periodic;
+        cout << "Task template " << i << ": SLA" << shape.sla << ", " << shape.memory << "MB, " << shape.instances << " instances"
+             << (is_periodic ? ", periodic every " : ", every ") << shape.period << "us +/- " << jitter << "us" << endl;
+    }
+    cout << "Task templates: " << templates.size() << " templates (" << periodic << " periodic) for " << instances << " tasks" << endl;
+}
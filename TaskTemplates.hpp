@@ -0,0 +1,54 @@
+//
+//  TaskTemplates.hpp
+//  CloudSim
+//
+//  Recurring task templates. The attributes that are shared by every
+//  occurrence of a recurring job (VM type, CPU type, SLA, memory and GPU)
+//  are interned once in a template, together with the period and jitter of
+//  its arrivals. A task is then referred to by an instance that only holds
+//  its id, its template and its arrival time; the remaining instructions
+//  stay with the task. This is an analysis aid and saves no memory: the
+//  simulator creates and keeps its full record of every task, and only the
+//  omega instances read the attributes from the templates. The report
+//  gives the templates found and how periodic their arrivals are.
+//
+
+#ifndef TaskTemplates_hpp
+#define TaskTemplates_hpp
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "Interfaces.h"
+
+typedef struct {
+    VMType_t vm_type;
+    CPUType_t cpu;
+    SLAType_t sla;
+    unsigned memory;
+    bool gpu_capable;
+    uint64_t instances;
+    Time_t last_arrival;
+    double period;                          // Mean time between arrivals
+    double spread;                          // Sum of the squared deviations from the period
+} TaskTemplate_t;
+
+typedef struct {
+    TaskId_t task_id;
+    unsigned template_id;
+    Time_t arrival;
+} TaskInstance_t;
+
+class TaskTemplates {
+public:
+    TaskTemplates()             {}
+    const TaskTemplate_t & Get(unsigned template_id) const { return templates[template_id]; }
+    TaskInstance_t Instance(Time_t now, TaskId_t task_id);
+    void Report();
+private:
+    vector<TaskTemplate_t> templates;
+    map<tuple<VMType_t, CPUType_t, SLAType_t, unsigned, bool>, unsigned> index;
+};
+
+#endif /* TaskTemplates_hpp */
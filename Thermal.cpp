@@ -0,0 +1,152 @@
+//
+//  Thermal.cpp
+//  CloudSim
+//
+
+#include <cmath>
+#include <sstream>
+
+#include "Internal_Interfaces.h"
+#include "Thermal.hpp"
+
+static void SetPState(MachineId_t machine_id, unsigned num_cpus, CPUPerformance_t p_state) {
+    for(unsigned core = 0; core < num_cpus; core++)
+        Machine_SetCorePerformance(machine_id, core, p_state);
+}
+
+void Thermal::Init(Time_t now, const ThermalConfig_t & config, string trace_path, Slowdown * slowdown) {
+    this->config = config;
+    this->slowdown = slowdown;
+    if(config.rack_size == 0 || config.resistance <= 0 || config.capacitance <= 0)
+        ThrowException("Thermal::Init(): Rack size, thermal resistance and capacitance must be positive");
+    Track(now);
+    if(!trace_path.empty()) {
+        trace.open(trace_path);
+        trace << "time,machine,inlet,temperature,p_state" << '\n';
+    }
+}
+
+void Thermal::Track(Time_t now) {
+    // Machines added while the simulation runs start at the ambient temperature
+    for(unsigned i = unsigned(machines.size()); i < Machine_GetTotal(); i++) {
+        machines.push_back(ThermalMachine_t{config.ambient, config.ambient, now, Machine_GetEnergy(MachineId_t(i)), P0, P0, P0,
+                                            false, config.turbo_ratio > 0, {}, config.ambient, 0, 0});
+    }
+}
+
+void Thermal::EndTurbo(MachineId_t machine_id) {
+    ThermalMachine_t & machine = machines[machine_id];
+    for(auto task_id: machine.turbo_tasks) {
+        slowdown->Set(task_id, TURBO_SLOWDOWN, 1);
+        slowdown->Apply(task_id, machine_id, true);
+    }
+    machine.turbo_tasks.clear();
+    machine.turbo = false;
+}
+
+void Thermal::PeriodicCheck(Time_t now) {
+    Track(now);
+    // Power drawn by every machine since the last check, turbo cores at their extra power. Microjoules per microsecond are watts
+    vector<double> power(machines.size(), 0);
+    for(unsigned i = 0; i < machines.size(); i++) {
+        ThermalMachine_t & machine = machines[i];
+        double elapsed = double(now - machine.last_update);
+        uint64_t energy = Machine_GetEnergy(MachineId_t(i));
+        if(elapsed > 0)
+            power[i] = double(energy - machine.energy) / elapsed;
+        machine.energy = energy;
+        if(!machine.turbo_tasks.empty()) {
+            MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+            double extra = (config.turbo_power - 1) * info.p_states[P0] * double(min<size_t>(machine.turbo_tasks.size(), info.num_cpus));
+            power[i] += extra;
+            turbo_energy += extra * elapsed;
+            machine.turbo_time += now - machine.last_update;
+        }
+    }
+    for(unsigned rack = 0; rack < machines.size(); rack += config.rack_size) {
+        double rack_power = 0;
+        for(unsigned i = rack; i < min<size_t>(rack + config.rack_size, machines.size()); i++)
+            rack_power += power[i];
+        for(unsigned i = rack; i < min<size_t>(rack + config.rack_size, machines.size()); i++)
+            machines[i].inlet = config.ambient + config.recirculation * rack_power;
+    }
+
+    for(unsigned i = 0; i < machines.size(); i++) {
+        ThermalMachine_t & machine = machines[i];
+        MachineId_t machine_id = MachineId_t(i);
+        double elapsed = double(now - machine.last_update) / 1000000;
+        double target = machine.inlet + power[i] * config.resistance;
+        machine.temperature = target + (machine.temperature - target) * exp(-elapsed / (config.resistance * config.capacitance));
+        machine.peak = max(machine.peak, machine.temperature);
+        if(machine.cap != P0)
+            machine.throttled_time += now - machine.last_update;
+        machine.last_update = now;
+
+        MachineInfo_t info = Machine_GetInfo(machine_id);
+        if(trace.is_open())
+            trace << now << ',' << i << ',' << machine.inlet << ',' << machine.temperature << ',' << info.p_state << '\n';
+        if(info.s_state != S0)
+            continue;
+        // The cap moves one P-state per check. A P-state other than the one the cap set was chosen by a policy since
+        if(machine.temperature > config.throttle && machine.cap < P_STATES - 1) {
+            machine.cap = CPUPerformance_t(machine.cap + 1);
+            SimOutput("Thermal::PeriodicCheck(): Machine " + to_string(i) + " throttled to P" + to_string(machine.cap) + " at " + to_string(now), 2);
+        }
+        else if(machine.temperature < config.throttle - config.hysteresis && machine.cap > P0)
+            machine.cap = CPUPerformance_t(machine.cap - 1);
+        if(!machine.clamped || info.p_state != machine.applied)
+            machine.wanted = info.p_state;
+        CPUPerformance_t p_state = max(machine.wanted, machine.cap);
+        machine.clamped = p_state != machine.wanted;
+        if(p_state != info.p_state) {
+            SetPState(machine_id, info.num_cpus, p_state);
+            machine.applied = p_state;
+        }
+
+        if(machine.turbo && machine.temperature >= config.turbo_limit)
+            EndTurbo(machine_id);
+        else if(!machine.turbo && config.turbo_ratio > 0 && machine.temperature < config.turbo_limit - config.hysteresis)
+            machine.turbo = true;
+    }
+}
+
+void Thermal::TaskPlaced(TaskId_t task_id, MachineId_t machine_id) {
+    // Called before the task is added, the scheduler applies the ledger once every model placed it
+    if(machine_id >= machines.size() || !machines[machine_id].turbo || Machine_GetInfo(machine_id).p_state != P0)
+        return;
+    slowdown->Set(task_id, TURBO_SLOWDOWN, 1 / config.turbo_ratio);
+    machines[machine_id].turbo_tasks.insert(task_id);
+    turbo_tasks++;
+}
+
+void Thermal::TasksCompleted(span<const TaskId_t> task_ids) {
+    for(auto & machine: machines) {
+        if(machine.turbo_tasks.empty())
+            continue;
+        for(auto task_id: task_ids)
+            machine.turbo_tasks.erase(task_id);
+    }
+}
+
+void Thermal::Report() {
+    unsigned hottest = 0;
+    double throttled = 0, turbo = 0;
+    for(unsigned i = 0; i < machines.size(); i++) {
+        ThermalMachine_t & machine = machines[i];
+        if(machine.peak > machines[hottest].peak)
+            hottest = i;
+        throttled += double(machine.throttled_time) / 1000000;
+        turbo += double(machine.turbo_time) / 1000000;
+        ostringstream line;
+        line << "Thermal::Report(): Machine " << i << " peak " << machine.peak << "C, final " << machine.temperature << "C, throttled "
+             << double(machine.throttled_time) / 1000000 << "s, turbo " << double(machine.turbo_time) / 1000000 << "s";
+        SimOutput(line.str(), 1);
+    }
+    if(machines.empty())
+        return;
+    cout << "Thermal: peak " << machines[hottest].peak << "C on machine " << hottest << ", " << throttled << "s of machine time throttled" << endl;
+    cout << "Thermal: " << turbo_tasks << " tasks started in turbo, " << turbo << "s of machine time in turbo, turbo energy "
+         << turbo_energy / 3600000000000.0 << "KW-Hour" << endl;
+    if(trace.is_open())
+        trace.close();
+}
@@ -0,0 +1,83 @@
+//
+//  Thermal.hpp
+//  CloudSim
+//
+//  RC thermal model. Every machine has a temperature driven by the power it
+//  drew since the last periodic check, settling towards its inlet plus
+//  power times the thermal resistance with the RC time constant. Machines
+//  are grouped in racks, and the inlet of a rack rises with the power of
+//  the rack through recirculation. Above the throttle temperature the
+//  machine is capped one P-state slower per check, and the cap is lifted
+//  again once it has cooled by the hysteresis. The cap only bounds the
+//  speed: a machine a policy runs slower than the cap is left alone, and
+//  lifting the cap gives back the P-state the policy chose, never a faster
+//  one. Below the turbo limit a machine has turbo headroom: tasks placed on
+//  it run faster than P0, at extra power, through a turbo factor in the
+//  slowdown ledger since the simulator has no P-state faster than P0. When
+//  the machine heats past the limit the factor of its turbo tasks is
+//  dropped again, and they get back the instructions they were spared. The
+//  temperatures can be written out as a CSV time series.
+//
+
+#ifndef Thermal_hpp
+#define Thermal_hpp
+
+#include <fstream>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+#include "Slowdown.hpp"
+
+typedef struct {
+    double ambient;                         // Inlet temperature of a rack without load, in Celsius
+    double resistance;                      // Celsius above inlet per watt at steady state
+    double capacitance;                     // Joules per Celsius
+    double throttle;                        // Temperature above which the machine is slowed down
+    double hysteresis;                      // Cooling below the throttle temperature before the cap is lifted
+    unsigned rack_size;                     // Consecutive machines that share an inlet
+    double recirculation;                   // Celsius of inlet rise per watt drawn by the rack
+    double turbo_ratio;                     // Speed of turbo against P0, 0 disables turbo
+    double turbo_power;                     // Active core power of turbo against P0
+    double turbo_limit;                     // Temperature below which the machine has turbo headroom
+} ThermalConfig_t;
+
+typedef struct {
+    double temperature;
+    double inlet;
+    Time_t last_update;
+    uint64_t energy;                        // Machine energy at last_update
+    CPUPerformance_t cap;                   // Fastest P-state the machine is allowed, P0 when not throttled
+    CPUPerformance_t wanted;                // P-state the policy chose, restored once the cap allows it
+    CPUPerformance_t applied;               // P-state the cap last set
+    bool clamped;                           // The machine runs at applied instead of wanted
+    bool turbo;                             // Turbo headroom left
+    set<TaskId_t> turbo_tasks;
+    double peak;
+    Time_t throttled_time;
+    Time_t turbo_time;
+} ThermalMachine_t;
+
+class Thermal {
+public:
+    Thermal()                   {}
+    void Init(Time_t now, const ThermalConfig_t & config, string trace_path, Slowdown * slowdown);
+    void PeriodicCheck(Time_t now);
+    void Report();
+    void TaskPlaced(TaskId_t task_id, MachineId_t machine_id);
+    void TasksCompleted(span<const TaskId_t> task_ids);
+private:
+    void EndTurbo(MachineId_t machine_id);
+    void Track(Time_t now);
+
+    ThermalConfig_t config;
+    Slowdown * slowdown;
+    vector<ThermalMachine_t> machines;
+    ofstream trace;
+    uint64_t turbo_tasks = 0;
+    double turbo_energy = 0;                // Extra energy of turbo over P0, in microjoules
+};
+
+#endif /* Thermal_hpp */
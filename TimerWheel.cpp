@@ -0,0 +1,147 @@
+//
+//  TimerWheel.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+
+#include "TimerWheel.hpp"
+
+static const uint64_t max_delta = (uint64_t(1) << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1;
+
+TimerWheel::TimerWheel() {
+    current_tick = 0;
+    pending = 0;
+    slots.assign(WHEEL_LEVELS * WHEEL_SLOTS, -1);
+    level_count.assign(WHEEL_LEVELS, 0);
+}
+
+TimerId_t TimerWheel::Schedule(Time_t time, uint64_t cookie) {
+    unsigned node;
+    if(free_nodes.empty()) {
+        node = unsigned(nodes.size());
+        nodes.push_back(TimerNode_t{0, 0, 0, 0, -1, -1, -1, false});
+    }
+    else {
+        node = free_nodes.back();
+        free_nodes.pop_back();
+    }
+    TimerNode_t & timer = nodes[node];
+    timer.time = time;
+    timer.cookie = cookie;
+    timer.tick = time / WHEEL_RESOLUTION;
+    timer.generation++;
+    timer.active = true;
+    pending++;
+    if(timer.tick <= current_tick)
+        due.push_back(node);
+    else
+        Insert(node);
+    return (TimerId_t(timer.generation) << 32) | node;
+}
+
+bool TimerWheel::Cancel(TimerId_t timer_id) {
+    unsigned node = unsigned(timer_id & 0xffffffff);
+    if(node >= nodes.size() || !nodes[node].active || nodes[node].generation != unsigned(timer_id >> 32))
+        return false;
+    if(nodes[node].slot >= 0)
+        Unlink(node);
+    else
+        due.erase(remove(due.begin(), due.end(), node), due.end());
+    nodes[node].active = false;
+    free_nodes.push_back(node);
+    pending--;
+    return true;
+}
+
+void TimerWheel::Advance(Time_t now, TimerCallback_t callback) {
+    // Timers in the current tick that are not due yet stay on the due list
+    vector<unsigned> fired, waiting;
+    for(auto node: due)
+        (nodes[node].time <= now ? fired : waiting).push_back(node);
+    due.swap(waiting);
+    uint64_t target = now / WHEEL_RESOLUTION;
+    while(current_tick < target) {
+        // Nothing can fire before the next cascade of the lowest non-empty level, so skip to it
+        unsigned empty = 0;
+        while(empty < WHEEL_LEVELS && level_count[empty] == 0)
+            empty++;
+        uint64_t next = empty == WHEEL_LEVELS ? target + 1 : (current_tick | ((uint64_t(1) << (empty * WHEEL_SLOT_BITS)) - 1)) + 1;
+        if(next > target) {
+            current_tick = target;
+            break;
+        }
+        current_tick = next;
+        if((current_tick & (WHEEL_SLOTS - 1)) == 0) {
+            for(unsigned level = 1; level < WHEEL_LEVELS; level++) {
+                Cascade(level);
+                if(((current_tick >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1)) != 0)
+                    break;
+            }
+        }
+        int & head = slots[current_tick & (WHEEL_SLOTS - 1)];
+        while(head >= 0) {
+            unsigned node = unsigned(head);
+            Unlink(node);
+            (nodes[node].time <= now ? fired : due).push_back(node);
+        }
+    }
+
+    sort(fired.begin(), fired.end(), [this](unsigned a, unsigned b) {
+        return nodes[a].time != nodes[b].time ? nodes[a].time < nodes[b].time : a < b;
+    });
+    // An earlier callback may cancel a collected timer and reuse its node for a new one, which the generation tells apart
+    vector<unsigned> generations;
+    for(auto node: fired)
+        generations.push_back(nodes[node].generation);
+    for(unsigned i = 0; i < fired.size(); i++) {
+        unsigned node = fired[i];
+        if(!nodes[node].active || nodes[node].generation != generations[i])
+            continue;
+        uint64_t cookie = nodes[node].cookie;
+        nodes[node].active = false;
+        free_nodes.push_back(node);
+        pending--;
+        callback(now, cookie);
+    }
+}
+
+void TimerWheel::Cascade(unsigned level) {
+    int & head = slots[level * WHEEL_SLOTS + ((current_tick >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1))];
+    while(head >= 0) {
+        unsigned node = unsigned(head);
+        Unlink(node);
+        Insert(node);
+    }
+}
+
+void TimerWheel::Insert(unsigned node) {
+    TimerNode_t & timer = nodes[node];
+    uint64_t delta = timer.tick - current_tick;
+    uint64_t tick = timer.tick;
+    unsigned level = 0;
+    while(level < WHEEL_LEVELS - 1 && delta >= (uint64_t(1) << ((level + 1) * WHEEL_SLOT_BITS)))
+        level++;
+    if(delta > max_delta)
+        tick = current_tick + max_delta;    // Parked in the last level, re-inserted when it cascades
+    int slot = int(level * WHEEL_SLOTS + ((tick >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1)));
+    timer.slot = slot;
+    level_count[level]++;
+    timer.prev = -1;
+    timer.next = slots[slot];
+    if(slots[slot] >= 0)
+        nodes[slots[slot]].prev = int(node);
+    slots[slot] = int(node);
+}
+
+void TimerWheel::Unlink(unsigned node) {
+    TimerNode_t & timer = nodes[node];
+    if(timer.prev >= 0)
+        nodes[timer.prev].next = timer.next;
+    else
+        slots[timer.slot] = timer.next;
+    if(timer.next >= 0)
+        nodes[timer.next].prev = timer.prev;
+    level_count[timer.slot / WHEEL_SLOTS]--;
+    timer.prev = timer.next = timer.slot = -1;
+}
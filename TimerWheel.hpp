@@ -0,0 +1,56 @@
+//
+//  TimerWheel.hpp
+//  CloudSim
+//
+//  Hierarchical timing wheel backing the scheduler one-shot timers. Four
+//  levels of 64 slots at 1ms resolution cover about 4.6 hours; later timers
+//  are parked in the last level and cascaded down as time advances.
+//
+
+#ifndef TimerWheel_hpp
+#define TimerWheel_hpp
+
+#include <vector>
+
+#include "SimTypes.h"
+
+#define WHEEL_LEVELS        4
+#define WHEEL_SLOT_BITS     6
+#define WHEEL_SLOTS         (1 << WHEEL_SLOT_BITS)
+#define WHEEL_RESOLUTION    1000            // Microseconds per tick
+
+typedef void (*TimerCallback_t)(Time_t time, uint64_t cookie);
+
+class TimerWheel {
+public:
+    TimerWheel();
+    void     Advance(Time_t now, TimerCallback_t callback);
+    bool     Cancel(TimerId_t timer_id);
+    unsigned GetPending()       { return pending; }
+    TimerId_t Schedule(Time_t time, uint64_t cookie);
+private:
+    typedef struct {
+        Time_t time;
+        uint64_t cookie;
+        uint64_t tick;
+        unsigned generation;                // Distinguishes reuses of the node in timer ids
+        int prev;                           // Slot list links, -1 terminates
+        int next;
+        int slot;                           // Slot the node is linked into, -1 when not linked
+        bool active;
+    } TimerNode_t;
+
+    void Cascade(unsigned level);
+    void Insert(unsigned node);
+    void Unlink(unsigned node);
+
+    uint64_t current_tick;
+    unsigned pending;
+    vector<TimerNode_t> nodes;
+    vector<unsigned> free_nodes;
+    vector<int> slots;                      // WHEEL_LEVELS * WHEEL_SLOTS list heads
+    vector<unsigned> level_count;           // Timers linked into each level
+    vector<unsigned> due;                   // Timers scheduled at or before the current tick
+};
+
+#endif /* TimerWheel_hpp */
@@ -0,0 +1,71 @@
+//
+//  TimerWheelTest.cpp
+//  CloudSim
+//
+//  Checks of the timer wheel that need no simulation, run with make test.
+//
+
+#include "TimerWheel.hpp"
+
+static TimerWheel * wheel;
+static vector<pair<Time_t, uint64_t> > calls;
+static TimerId_t victim;
+static unsigned failures = 0;
+
+static void Check(bool condition, string what) {
+    if(!condition) {
+        cout << "FAILED: " << what << endl;
+        failures++;
+    }
+}
+
+static void Record(Time_t time, uint64_t cookie) {
+    calls.push_back({time, cookie});
+}
+
+static void CancelAndReschedule(Time_t time, uint64_t cookie) {
+    // The first timer cancels the second, which fired with it, and schedules a later one in its freed node
+    calls.push_back({time, cookie});
+    if(cookie == 1) {
+        wheel->Cancel(victim);
+        wheel->Schedule(100000, 3);
+    }
+}
+
+static void TestCancelThenRescheduleInCallback() {
+    TimerWheel timers;
+    wheel = &timers;
+    calls.clear();
+    timers.Schedule(5000, 1);
+    victim = timers.Schedule(5000, 2);
+    timers.Advance(5000, CancelAndReschedule);
+    Check(calls.size() == 1 && calls[0].second == 1, "only the cancelling timer fires at 5000");
+    Check(timers.GetPending() == 1, "the rescheduled timer is pending");
+
+    // The freed nodes must each be handed out once, so two new timers keep nodes of their own
+    timers.Schedule(50000, 4);
+    timers.Schedule(60000, 5);
+    calls.clear();
+    timers.Advance(200000, Record);
+    Check(calls.size() == 3, "the three later timers fire once each");
+    Check(calls.size() == 3 && calls[0].second == 4 && calls[1].second == 5 && calls[2].second == 3, "the later timers fire in time order");
+    Check(timers.GetPending() == 0, "nothing is left pending");
+}
+
+static void TestCancelPending() {
+    TimerWheel timers;
+    calls.clear();
+    TimerId_t timer_id = timers.Schedule(70000, 1);
+    timers.Schedule(80000, 2);
+    Check(timers.Cancel(timer_id), "a pending timer can be cancelled");
+    Check(!timers.Cancel(timer_id), "a cancelled timer cannot be cancelled again");
+    timers.Advance(100000, Record);
+    Check(calls.size() == 1 && calls[0].second == 2, "only the timer left fires");
+}
+
+int main() {
+    TestCancelThenRescheduleInCallback();
+    TestCancelPending();
+    cout << (failures ? "TimerWheelTest: " + to_string(failures) + " checks failed" : string("TimerWheelTest: passed")) << endl;
+    return failures ? 1 : 0;
+}